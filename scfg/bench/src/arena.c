@@ -0,0 +1,84 @@
+// arena.c
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <bench.h>
+#include <stddef.h>
+
+#define _BLOB_COUNT       1024 // buffers alive at the same time
+#define _BLOB_ROUND_COUNT 1000
+#define _MAX_BLOB_SIZE    4096
+#define _ARENA_BLOCK_SIZE 4194304 // 4 MiB, enough for one round, so a reset arena does not call malloc()
+
+static scfg_byte_buffer_t _Blobs[_BLOB_COUNT];
+static size_t _Blob_sizes[_BLOB_COUNT];
+
+static int _Run_blob_rounds(
+    const scfg_allocator_t* const _Al, scfg_arena_t* const _Arena, double* const _Rate) {
+    // Note: Each round creates every blob and then releases all of them, like a batch of parsed configs.
+    //       The arena frees its memory at once when it is reset after the round.
+    const double _Start = _Get_time();
+    for (size_t _Round = 0; _Round < _BLOB_ROUND_COUNT; ++_Round) {
+        for (size_t _Idx = 0; _Idx < _BLOB_COUNT; ++_Idx) {
+            scfg_initialize_buffer(&_Blobs[_Idx], scfg_buffer_type_byte);
+            if (scfg_resize_buffer(&_Blobs[_Idx], scfg_buffer_type_byte, _Blob_sizes[_Idx], _Al)
+                != scfg_error_success) {
+                return 1;
+            }
+        }
+
+        for (size_t _Idx = 0; _Idx < _BLOB_COUNT; ++_Idx) {
+            scfg_release_buffer(&_Blobs[_Idx], scfg_buffer_type_byte, _Al);
+        }
+
+        if (_Arena) {
+            scfg_reset_arena(_Arena);
+        }
+    }
+
+    *_Rate = (double) (_BLOB_ROUND_COUNT * _BLOB_COUNT) / (_Get_time() - _Start);
+    return 0;
+}
+
+static int _Run_best_blob_rounds(
+    const scfg_allocator_t* const _Al, scfg_arena_t* const _Arena, double* const _Best) {
+    *_Best = 0.0;
+    for (size_t _Run = 0; _Run < _BENCH_REPEAT; ++_Run) {
+        double _Rate;
+        if (_Run_blob_rounds(_Al, _Arena, &_Rate) != 0) {
+            return 1;
+        }
+
+        *_Best = _SCFG_MAX(*_Best, _Rate);
+    }
+
+    return 0;
+}
+
+int _Bench_arena(void) {
+    // compares the default malloc() path of scfg_resize_buffer() with an arena
+    uint32_t _State = 0x2545F491;
+    for (size_t _Idx = 0; _Idx < _BLOB_COUNT; ++_Idx) { // all blobs are large, so each one allocates
+        _Blob_sizes[_Idx] = _SCFG_SMALL_BUFFER_SIZE + 1 + _Next_random(&_State) % _MAX_BLOB_SIZE;
+    }
+
+    double _Rate;
+    if (_Run_best_blob_rounds(NULL, NULL, &_Rate) != 0) {
+        return 1;
+    }
+
+    _Print_result("arena", "malloc", _Rate, "buffers");
+    scfg_arena_t _Arena;
+    scfg_allocator_t _Al;
+    scfg_initialize_arena(&_Arena, _ARENA_BLOCK_SIZE);
+    scfg_get_arena_allocator(&_Arena, &_Al);
+    const int _Err = _Run_best_blob_rounds(&_Al, &_Arena, &_Rate);
+    scfg_release_arena(&_Arena);
+    if (_Err != 0) {
+        return 1;
+    }
+
+    _Print_result("arena", "arena", _Rate, "buffers");
+    return 0;
+}
\ No newline at end of file
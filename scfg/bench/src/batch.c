@@ -0,0 +1,111 @@
+// batch.c
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <bench.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#define _BATCH_MESSAGE_COUNT 4096
+#define _BATCH_MAX_SIZE      1024
+#define _BATCH_ROUNDS        20 // batches hashed per run
+
+struct _Batch_hash {
+    const char* _Name;
+    scfg_hash_id_t _Id;
+};
+
+struct _Batch_messages {
+    const char* _Name;
+    size_t _Min_size;
+    size_t _Max_size;
+};
+
+static const struct _Batch_hash _Batch_hashes[] = {
+    {"blake3", scfg_hash_id_blake3},
+    {"sha3-512", scfg_hash_id_sha512},
+    {"whirlpool", scfg_hash_id_whirlpool},
+    {"sha-256", scfg_hash_id_sha2_256},
+};
+
+static const struct _Batch_messages _Batch_sets[] = {{"64 B", 64, 64}, {"1..1024 B", 1, _BATCH_MAX_SIZE}};
+
+static uint8_t _Batch_data[_BATCH_MESSAGE_COUNT * _BATCH_MAX_SIZE];
+static const uint8_t* _Batch_ptrs[_BATCH_MESSAGE_COUNT];
+static size_t _Batch_sizes[_BATCH_MESSAGE_COUNT];
+
+static void _Fill_batch(const struct _Batch_messages* const _Set) {
+    uint32_t _State = 0x510E527F;
+    for (size_t _Idx = 0; _Idx < _BATCH_MESSAGE_COUNT; ++_Idx) {
+        _Batch_ptrs[_Idx]  = _Batch_data + _Idx * _BATCH_MAX_SIZE;
+        _Batch_sizes[_Idx] =
+            _Set->_Min_size + _Next_random(&_State) % (_Set->_Max_size - _Set->_Min_size + 1);
+    }
+}
+
+static int _Hash_messages(
+    const scfg_hash_id_t _Id, const int _Batched, uint8_t* const _Out, scfg_byte_buffer_t* const _Buf) {
+    // hashes the whole batch either with one scfg_hash_batch() call or with one call per message
+    if (_Batched) {
+        return scfg_hash_batch(_Batch_ptrs, _Batch_sizes, _BATCH_MESSAGE_COUNT, _Id, _Buf)
+            != scfg_error_success;
+    }
+
+    for (size_t _Idx = 0; _Idx < _BATCH_MESSAGE_COUNT; ++_Idx) {
+        const scfg_byte_view_t _Data = {_Batch_ptrs[_Idx], _Batch_sizes[_Idx]};
+        if (scfg_hash_byte_view(_Data, _Id, _Out + _Idx * 64, 64, NULL) != scfg_error_success) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static int _Print_batch(const struct _Batch_hash* const _Hash, const struct _Batch_messages* const _Set,
+    const int _Batched, uint8_t* const _Out, scfg_byte_buffer_t* const _Buf) {
+    double _Best = 0.0;
+    for (size_t _Run = 0; _Run < _BENCH_REPEAT; ++_Run) {
+        const double _Start = _Get_time();
+        for (size_t _Round = 0; _Round < _BATCH_ROUNDS; ++_Round) {
+            if (_Hash_messages(_Hash->_Id, _Batched, _Out, _Buf) != 0) {
+                return 1;
+            }
+        }
+
+        const double _Rate = (double) _BATCH_MESSAGE_COUNT * _BATCH_ROUNDS / (_Get_time() - _Start);
+        _Best              = _SCFG_MAX(_Best, _Rate);
+    }
+
+    char _Variant[64];
+    snprintf(_Variant, sizeof(_Variant), "%s, %s, %s", _Hash->_Name, _Set->_Name,
+        _Batched ? "batch" : "per message");
+    _Print_result("batch", _Variant, _Best, "messages");
+    return 0;
+}
+
+int _Bench_batch(void) {
+    // Note: Hashes 4096 messages per batch with every hash, once through scfg_hash_batch() and once
+    //       with one scfg_hash_byte_view() call per message.
+    uint32_t _State = 0x1F83D9AB;
+    for (size_t _Idx = 0; _Idx < sizeof(_Batch_data); ++_Idx) {
+        _Batch_data[_Idx] = (uint8_t) _Next_random(&_State);
+    }
+
+    scfg_byte_buffer_t _Buf;
+    scfg_initialize_buffer(&_Buf, scfg_buffer_type_byte);
+    uint8_t* _Out;
+    int _Err = scfg_resize_buffer(&_Buf, scfg_buffer_type_byte, _BATCH_MESSAGE_COUNT * 64, NULL)
+                != scfg_error_success
+            || scfg_get_associated_buffer(&_Buf, scfg_buffer_type_byte, (void**) &_Out) != scfg_error_success;
+    for (size_t _Set = 0; !_Err && _Set < sizeof(_Batch_sets) / sizeof(_Batch_sets[0]); ++_Set) {
+        _Fill_batch(&_Batch_sets[_Set]);
+        for (size_t _Hash = 0; !_Err && _Hash < sizeof(_Batch_hashes) / sizeof(_Batch_hashes[0]); ++_Hash) {
+            _Err = _Print_batch(&_Batch_hashes[_Hash], &_Batch_sets[_Set], 0, _Out, &_Buf)
+                || _Print_batch(&_Batch_hashes[_Hash], &_Batch_sets[_Set], 1, _Out, &_Buf);
+        }
+    }
+
+    scfg_release_buffer(&_Buf, scfg_buffer_type_byte, NULL);
+    return _Err;
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+// bench.h
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef _BENCH_H_
+#define _BENCH_H_
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#include <inc/scfg.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define _BENCH_REPEAT 5 // each variant is run this many times, the best run is reported
+
+// returns the current time in seconds, only differences between two calls are meaningful
+double _Get_time(void);
+
+// returns the next value of a fixed pseudo-random sequence, so every run uses the same inputs
+uint32_t _Next_random(uint32_t* const _State);
+
+// prints one result, _Rate is the number of _Unit per second
+void _Print_result(const char* const _Bench, const char* const _Variant, const double _Rate,
+    const char* const _Unit);
+
+// each benchmark prints its results and returns 0, or returns 1 if the library reported an error
+int _Bench_arena(void);
+int _Bench_pool(void);
+int _Bench_sha3(void);
+int _Bench_file(void);
+int _Bench_batch(void);
+#endif // _BENCH_H_
\ No newline at end of file
@@ -0,0 +1,99 @@
+// file.c
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <bench.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define _FILE_BENCH_SIZE 67108864 // 64 MiB
+#define _FILE_WRITE_SIZE 1048576
+
+static const size_t _Chunk_sizes[] = {1024, 4096, 16384, 65536, 262144, 1048576};
+
+static FILE* _Create_bench_file(wchar_t* const _Path) {
+    // creates a temporary file of _FILE_BENCH_SIZE pseudo-random bytes, _Path receives its name
+    wchar_t _Dir[MAX_PATH];
+    const DWORD _Dir_size = GetTempPathW(MAX_PATH, _Dir);
+    if (_Dir_size == 0 || _Dir_size > MAX_PATH || GetTempFileNameW(_Dir, L"scf", 0, _Path) == 0) {
+        return NULL;
+    }
+
+    FILE* const _Stream   = _wfopen(_Path, L"w+b");
+    uint32_t* const _Data = (uint32_t*) malloc(_FILE_WRITE_SIZE);
+    int _Err              = !_Stream || !_Data;
+    uint32_t _State       = 0x3C6EF372;
+    for (size_t _Written = 0; !_Err && _Written < _FILE_BENCH_SIZE; _Written += _FILE_WRITE_SIZE) {
+        for (size_t _Idx = 0; _Idx < _FILE_WRITE_SIZE / sizeof(uint32_t); ++_Idx) {
+            _Data[_Idx] = _Next_random(&_State);
+        }
+
+        _Err = fwrite(_Data, 1, _FILE_WRITE_SIZE, _Stream) != _FILE_WRITE_SIZE;
+    }
+
+    free(_Data);
+    if (_Err || fflush(_Stream) != 0) {
+        if (_Stream) {
+            fclose(_Stream);
+        }
+
+        _wremove(_Path);
+        return NULL;
+    }
+
+    return _Stream;
+}
+
+static int _Hash_bench_file(FILE* const _Stream, const scfg_file_hash_options_t* const _Options,
+    scfg_byte_buffer_t* const _Buf, double* const _Best) {
+    *_Best = 0.0;
+    for (size_t _Run = 0; _Run < _BENCH_REPEAT; ++_Run) {
+        const double _Start = _Get_time();
+        if (scfg_hash_file_with_options(_Stream, 0, scfg_hash_id_blake3, _Options, _Buf)
+            != scfg_error_success) {
+            return 1;
+        }
+
+        const double _Rate = _FILE_BENCH_SIZE / 1048576.0 / (_Get_time() - _Start);
+        *_Best             = _SCFG_MAX(*_Best, _Rate);
+    }
+
+    return 0;
+}
+
+int _Bench_file(void) {
+    // Note: Hashes a 64 MiB file with BLAKE3 for each chunk size, through the stream and through the
+    //       reopened handle. The file was just written, so it is read from the system cache and the
+    //       results show the cost of each read rather than the speed of the disk.
+    wchar_t _Path[MAX_PATH];
+    FILE* const _Stream = _Create_bench_file(_Path);
+    if (!_Stream) {
+        return 1;
+    }
+
+    scfg_byte_buffer_t _Buf;
+    scfg_initialize_buffer(&_Buf, scfg_buffer_type_byte);
+    size_t _Hash_size;
+    int _Err = scfg_get_hash_size(scfg_hash_id_blake3, &_Hash_size) != scfg_error_success
+            || scfg_resize_buffer(&_Buf, scfg_buffer_type_byte, _Hash_size, NULL) != scfg_error_success;
+    for (size_t _Idx = 0; !_Err && _Idx < sizeof(_Chunk_sizes) / sizeof(_Chunk_sizes[0]); ++_Idx) {
+        for (int _Bypass = 0; !_Err && _Bypass < 2; ++_Bypass) {
+            const scfg_file_hash_options_t _Options = {_Chunk_sizes[_Idx], _Bypass};
+            double _Rate;
+            _Err = _Hash_bench_file(_Stream, &_Options, &_Buf, &_Rate);
+            if (!_Err) {
+                char _Variant[64];
+                snprintf(_Variant, sizeof(_Variant), "%zu KiB chunks, %s", _Chunk_sizes[_Idx] / 1024,
+                    _Bypass ? "file handle" : "stream");
+                _Print_result("file", _Variant, _Rate, "MiB");
+            }
+        }
+    }
+
+    scfg_release_buffer(&_Buf, scfg_buffer_type_byte, NULL);
+    fclose(_Stream);
+    _wremove(_Path);
+    return _Err;
+}
\ No newline at end of file
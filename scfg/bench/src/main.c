@@ -0,0 +1,83 @@
+// main.c
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <bench.h>
+#include <stdio.h>
+#include <string.h>
+
+struct _Bench {
+    const char* _Name;
+    int (*_Run)(void);
+};
+
+static const struct _Bench _Benches[] = {
+    {"arena", _Bench_arena},
+    {"pool", _Bench_pool},
+    {"sha3", _Bench_sha3},
+    {"file", _Bench_file},
+    {"batch", _Bench_batch},
+};
+
+#define _BENCH_COUNT (sizeof(_Benches) / sizeof(_Benches[0]))
+
+double _Get_time(void) {
+    LARGE_INTEGER _Freq;
+    LARGE_INTEGER _Now;
+    QueryPerformanceFrequency(&_Freq);
+    QueryPerformanceCounter(&_Now);
+    return (double) _Now.QuadPart / (double) _Freq.QuadPart;
+}
+
+uint32_t _Next_random(uint32_t* const _State) {
+    // xorshift32, the state must not be 0
+    *_State ^= *_State << 13;
+    *_State ^= *_State >> 17;
+    *_State ^= *_State << 5;
+    return *_State;
+}
+
+void _Print_result(const char* const _Bench, const char* const _Variant, const double _Rate,
+    const char* const _Unit) {
+    printf("%-8s %-32s %16.0f %s/s\n", _Bench, _Variant, _Rate, _Unit);
+}
+
+static int _Is_selected(const char* const _Name, const int _Argc, char** const _Argv) {
+    if (_Argc < 2) { // no names, run everything
+        return 1;
+    }
+
+    for (int _Arg = 1; _Arg < _Argc; ++_Arg) {
+        if (strcmp(_Argv[_Arg], _Name) == 0) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int main(int _Argc, char** _Argv) {
+    // Note: Each argument names a benchmark to run, without arguments every benchmark runs.
+    for (int _Arg = 1; _Arg < _Argc; ++_Arg) {
+        size_t _Idx = 0;
+        while (_Idx < _BENCH_COUNT && strcmp(_Argv[_Arg], _Benches[_Idx]._Name) != 0) {
+            ++_Idx;
+        }
+
+        if (_Idx == _BENCH_COUNT) {
+            fprintf(stderr, "unknown benchmark: %s\n", _Argv[_Arg]);
+            return 1;
+        }
+    }
+
+    int _Result = 0;
+    for (size_t _Idx = 0; _Idx < _BENCH_COUNT; ++_Idx) {
+        if (_Is_selected(_Benches[_Idx]._Name, _Argc, _Argv) && _Benches[_Idx]._Run() != 0) {
+            fprintf(stderr, "%s: the library reported an error\n", _Benches[_Idx]._Name);
+            _Result = 1;
+        }
+    }
+
+    return _Result;
+}
\ No newline at end of file
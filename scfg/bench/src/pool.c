@@ -0,0 +1,119 @@
+// pool.c
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <bench.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#define _POOL_MAX_THREADS     64 // the limit of WaitForMultipleObjects()
+#define _POOL_LIVE_BUFFERS    64 // buffers held by each thread
+#define _POOL_RESIZE_COUNT    200000 // resizes per thread
+#define _POOL_MAX_BUFFER_SIZE 16384
+
+struct _Pool_worker {
+    const scfg_allocator_t* _Al; // NULL selects malloc()
+    uint32_t _Seed;
+    int _Err;
+};
+
+static DWORD WINAPI _Run_pool_worker(void* const _Param) {
+    // Note: Each step releases one buffer and resizes it again, so most allocations reuse a block that
+    //       the same thread has just freed. That is the case the per-thread free lists are meant for.
+    struct _Pool_worker* const _Worker = (struct _Pool_worker*) _Param;
+    scfg_byte_buffer_t _Bufs[_POOL_LIVE_BUFFERS];
+    for (size_t _Idx = 0; _Idx < _POOL_LIVE_BUFFERS; ++_Idx) {
+        scfg_initialize_buffer(&_Bufs[_Idx], scfg_buffer_type_byte);
+    }
+
+    uint32_t _State = _Worker->_Seed;
+    for (size_t _Step = 0; _Step < _POOL_RESIZE_COUNT; ++_Step) {
+        scfg_byte_buffer_t* const _Buf = &_Bufs[_Step % _POOL_LIVE_BUFFERS];
+        const size_t _Size = _SCFG_SMALL_BUFFER_SIZE + 1 + _Next_random(&_State) % _POOL_MAX_BUFFER_SIZE;
+        scfg_release_buffer(_Buf, scfg_buffer_type_byte, _Worker->_Al);
+        if (scfg_resize_buffer_uninitialized(_Buf, scfg_buffer_type_byte, _Size, _Worker->_Al)
+            != scfg_error_success) {
+            _Worker->_Err = 1;
+            break;
+        }
+    }
+
+    for (size_t _Idx = 0; _Idx < _POOL_LIVE_BUFFERS; ++_Idx) {
+        scfg_release_buffer(&_Bufs[_Idx], scfg_buffer_type_byte, _Worker->_Al);
+    }
+
+    scfg_trim_pool_allocator(); // return this thread's cached blocks
+    return 0;
+}
+
+static int _Run_pool_threads(const scfg_allocator_t* const _Al, const size_t _Count, double* const _Rate) {
+    // Note: The threads are created suspended and resumed together, so thread creation is not timed.
+    struct _Pool_worker _Workers[_POOL_MAX_THREADS];
+    HANDLE _Threads[_POOL_MAX_THREADS];
+    size_t _Created = 0;
+    for (; _Created < _Count; ++_Created) {
+        _Workers[_Created]._Al   = _Al;
+        _Workers[_Created]._Seed = 0x9E3779B9 + (uint32_t) _Created;
+        _Workers[_Created]._Err  = 0;
+        _Threads[_Created] =
+            CreateThread(NULL, 0, _Run_pool_worker, &_Workers[_Created], CREATE_SUSPENDED, NULL);
+        if (!_Threads[_Created]) {
+            break;
+        }
+    }
+
+    const double _Start = _Get_time();
+    for (size_t _Idx = 0; _Idx < _Created; ++_Idx) {
+        ResumeThread(_Threads[_Idx]);
+    }
+
+    WaitForMultipleObjects((DWORD) _Created, _Threads, TRUE, INFINITE);
+    *_Rate   = (double) (_Created * _POOL_RESIZE_COUNT) / (_Get_time() - _Start);
+    int _Err = _Created < _Count;
+    for (size_t _Idx = 0; _Idx < _Created; ++_Idx) {
+        CloseHandle(_Threads[_Idx]);
+        _Err |= _Workers[_Idx]._Err;
+    }
+
+    return _Err;
+}
+
+static int _Print_pool_threads(
+    const char* const _Name, const scfg_allocator_t* const _Al, const size_t _Count) {
+    double _Best = 0.0;
+    for (size_t _Run = 0; _Run < _BENCH_REPEAT; ++_Run) {
+        double _Rate;
+        if (_Run_pool_threads(_Al, _Count, &_Rate) != 0) {
+            return 1;
+        }
+
+        _Best = _SCFG_MAX(_Best, _Rate);
+    }
+
+    char _Variant[64];
+    snprintf(_Variant, sizeof(_Variant), "%s, %zu thread%s", _Name, _Count, _Count == 1 ? "" : "s");
+    _Print_result("pool", _Variant, _Best, "resizes");
+    return 0;
+}
+
+int _Bench_pool(void) {
+    // compares malloc() with the pool allocator at 1, 2, 4 and so on up to one thread per processor
+    SYSTEM_INFO _Info;
+    GetSystemInfo(&_Info);
+    const size_t _Max_count = _SCFG_MIN((size_t) _Info.dwNumberOfProcessors, _POOL_MAX_THREADS);
+    scfg_allocator_t _Pool;
+    scfg_get_pool_allocator(&_Pool);
+    for (size_t _Count = 1;; _Count = _SCFG_MIN(_Count * 2, _Max_count)) {
+        if (_Print_pool_threads("malloc", NULL, _Count) != 0
+            || _Print_pool_threads("pool", &_Pool, _Count) != 0) {
+            return 1;
+        }
+
+        if (_Count == _Max_count) {
+            break;
+        }
+    }
+
+    return 0;
+}
\ No newline at end of file
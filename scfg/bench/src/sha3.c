@@ -0,0 +1,83 @@
+// sha3.c
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <bench.h>
+#include <openssl/evp.h>
+#include <stddef.h>
+
+#define _SHA3_MESSAGE_SIZE  64
+#define _SHA3_MESSAGE_COUNT 500000
+
+static uint8_t _Sha3_message[_SHA3_MESSAGE_SIZE];
+
+static int _Hash_with_new_context(double* const _Rate) {
+    // Note: This is what the library did before contexts were cached: every hash creates a context,
+    //       looks up the digest with EVP_sha3_512() and frees the context again.
+    uint8_t _Out[64];
+    const double _Start = _Get_time();
+    for (size_t _Idx = 0; _Idx < _SHA3_MESSAGE_COUNT; ++_Idx) {
+        EVP_MD_CTX* const _Ctx = EVP_MD_CTX_new();
+        if (!_Ctx) {
+            return 1;
+        }
+
+        unsigned int _Len;
+        const int _Succeeded = EVP_DigestInit_ex(_Ctx, EVP_sha3_512(), NULL) == 1
+                            && EVP_DigestUpdate(_Ctx, _Sha3_message, _SHA3_MESSAGE_SIZE) == 1
+                            && EVP_DigestFinal_ex(_Ctx, _Out, &_Len) == 1;
+        EVP_MD_CTX_free(_Ctx);
+        if (!_Succeeded) {
+            return 1;
+        }
+    }
+
+    *_Rate = _SHA3_MESSAGE_COUNT / (_Get_time() - _Start);
+    return 0;
+}
+
+static int _Hash_with_library(double* const _Rate) {
+    // uses the digest and the per-thread context cached by the library
+    const scfg_byte_view_t _Data = {_Sha3_message, _SHA3_MESSAGE_SIZE};
+    uint8_t _Out[64];
+    const double _Start = _Get_time();
+    for (size_t _Idx = 0; _Idx < _SHA3_MESSAGE_COUNT; ++_Idx) {
+        if (scfg_hash_byte_view(_Data, scfg_hash_id_sha512, _Out, sizeof(_Out), NULL) != scfg_error_success) {
+            return 1;
+        }
+    }
+
+    *_Rate = _SHA3_MESSAGE_COUNT / (_Get_time() - _Start);
+    return 0;
+}
+
+static int _Print_sha3(const char* const _Variant, int (*const _Run)(double* const)) {
+    double _Best = 0.0;
+    for (size_t _Run_idx = 0; _Run_idx < _BENCH_REPEAT; ++_Run_idx) {
+        double _Rate;
+        if (_Run(&_Rate) != 0) {
+            return 1;
+        }
+
+        _Best = _SCFG_MAX(_Best, _Rate);
+    }
+
+    _Print_result("sha3", _Variant, _Best, "hashes");
+    return 0;
+}
+
+int _Bench_sha3(void) {
+    // hashes 64-byte messages with SHA3-512, with and without cached digest contexts
+    uint32_t _State = 0x6A09E667;
+    for (size_t _Idx = 0; _Idx < _SHA3_MESSAGE_SIZE; ++_Idx) {
+        _Sha3_message[_Idx] = (uint8_t) _Next_random(&_State);
+    }
+
+    if (_Print_sha3("new context per hash", _Hash_with_new_context) != 0
+        || _Print_sha3("cached context", _Hash_with_library) != 0) {
+        return 1;
+    }
+
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,368 @@
+// scfg.h
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef _SCFG_H_
+#define _SCFG_H_
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <wchar.h>
+
+#ifdef SCFG_EXPORTS
+#define _SCFG_API __declspec(dllexport)
+#else // ^^^ SCFG_EXPORTS ^^^ / vvv !SCFG_EXPORTS vvv
+#define _SCFG_API __declspec(dllimport)
+#endif // SCFG_EXPORTS
+
+#define _SCFG_CONV __stdcall
+
+#define _SCFG_SMALL_BUFFER_SIZE 16 // the largest number of bytes that can be stored without an allocation
+#define _SCFG_ALLOCATOR_VERSION 1
+#define _SCFG_DEFAULT_ALIGNMENT (2 * sizeof(void*)) // the alignment of every block requested by the library
+#define _SCFG_MIN(_Left, _Right) ((_Left) < (_Right) ? (_Left) : (_Right))
+#define _SCFG_MAX(_Left, _Right) ((_Left) > (_Right) ? (_Left) : (_Right))
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+typedef int __bool_t;
+
+typedef enum scfg_error {
+    scfg_error_success,
+    scfg_error_general_failure,
+    scfg_error_not_enough_memory,
+    scfg_error_invalid_buffer,
+    scfg_error_invalid_data,
+    scfg_error_invalid_stream,
+    scfg_error_unknown_buffer_type,
+    scfg_error_buffer_too_small,
+    scfg_error_unsupported_hash,
+    scfg_error_code_point_too_large,
+    scfg_error_invalid_allocator,
+    scfg_error_invalid_arena,
+    scfg_error_read_only_buffer,
+    scfg_error_invalid_hasher,
+    scfg_error_invalid_manifest,
+    scfg_error_invalid_cache,
+    scfg_error_invalid_async_hash
+} scfg_error_t;
+
+typedef enum scfg_buffer_type {
+    scfg_buffer_type_byte,
+    scfg_buffer_type_utf8,
+    scfg_buffer_type_unicode,
+    scfg_buffer_type_mapped
+} scfg_buffer_type_t;
+
+// Note: Every allocator must set version to _SCFG_ALLOCATOR_VERSION. The context is passed
+//       unchanged to each callback, and deallocate() receives the size of the allocated block.
+typedef struct scfg_allocator {
+    uint32_t version;
+    void* context;
+    void* (*allocate)(void* const _Ctx, const size_t _Size, const size_t _Align);
+    void (*deallocate)(void* const _Ctx, void* const _Ptr, const size_t _Size);
+    void* (*reallocate)(void* const _Ctx, void* const _Ptr, const size_t _Old_size, const size_t _New_size,
+        const size_t _Align); // optional, may be NULL
+} scfg_allocator_t;
+
+// Note: An arena hands out memory by bumping a pointer, deallocation is a no-op. All memory
+//       is released at once by scfg_reset_arena() or scfg_release_arena().
+typedef struct scfg_arena {
+    struct scfg_arena_block* _Head; // the block that is currently in use
+    size_t _Block_size; // the minimum size of a new block
+} scfg_arena_t;
+
+// Note: All buffers use the small buffer optimization (SBO). The storage is small as long as
+//       _Capacity does not exceed _SCFG_SMALL_BUFFER_SIZE bytes, otherwise _Large is used.
+//       Once a buffer is moved to _Large, it stays there until scfg_shrink_buffer() or
+//       scfg_release_buffer() is called, so resizing around the SBO limit does not reallocate.
+typedef struct scfg_byte_buffer {
+    union {
+        uint8_t _Small[_SCFG_SMALL_BUFFER_SIZE];
+        uint8_t* _Large;
+    };
+
+    size_t _Size; // number of used bytes
+    size_t _Capacity; // number of bytes that can be stored without a reallocation
+} scfg_byte_buffer_t;
+
+typedef struct scfg_utf8_buffer {
+    union {
+        char _Small[_SCFG_SMALL_BUFFER_SIZE];
+        char* _Large;
+    };
+
+    size_t _Size; // number of used characters
+    size_t _Capacity; // number of characters that can be stored without a reallocation
+} scfg_utf8_buffer_t;
+
+typedef struct scfg_unicode_buffer {
+    union {
+        wchar_t _Small[_SCFG_SMALL_BUFFER_SIZE / sizeof(wchar_t)];
+        wchar_t* _Large;
+    };
+
+    size_t _Size; // number of used characters
+    size_t _Capacity; // number of characters that can be stored without a reallocation
+} scfg_unicode_buffer_t;
+
+// Note: A mapped buffer is a read-only view of a whole file, created by scfg_map_file(). It cannot
+//       be resized, and it must be released with scfg_release_buffer().
+typedef struct scfg_mapped_buffer {
+    const uint8_t* _Ptr; // mapped file contents
+    size_t _Size; // number of mapped bytes
+} scfg_mapped_buffer_t;
+
+// Note: Views refer to memory owned by someone else, they never allocate or release anything.
+typedef struct scfg_byte_view {
+    const uint8_t* data;
+    size_t size; // number of bytes
+} scfg_byte_view_t;
+
+typedef struct scfg_utf8_view {
+    const char* data;
+    size_t size; // number of characters
+} scfg_utf8_view_t;
+
+typedef struct scfg_unicode_view {
+    const wchar_t* data;
+    size_t size; // number of characters
+} scfg_unicode_view_t;
+
+typedef enum scfg_hash_id {
+    scfg_hash_id_blake3,
+    scfg_hash_id_sha512, // SHA3-512
+    scfg_hash_id_whirlpool,
+    scfg_hash_id_xxh3_64, // non-cryptographic
+    scfg_hash_id_xxh3_128, // non-cryptographic
+    scfg_hash_id_sha2_256,
+    scfg_hash_id_sha2_512
+} scfg_hash_id_t;
+
+// Note: Some hashes select a kernel for the current processor when they are first used.
+//       The external kernel means that the hash is computed by a third-party library.
+typedef enum scfg_hash_kernel {
+    scfg_hash_kernel_portable,
+    scfg_hash_kernel_sse2,
+    scfg_hash_kernel_avx2,
+    scfg_hash_kernel_sha_ni,
+    scfg_hash_kernel_external
+} scfg_hash_kernel_t;
+
+// Note: A hasher computes a hash from data that arrives in pieces. It is created by scfg_create_hasher()
+//       and must be released with scfg_release_hasher(). scfg_finalize_hasher() resets the hasher,
+//       so it can be reused for the next message.
+typedef struct scfg_hasher scfg_hasher_t;
+
+// Note: A manifest stores the hash of every fixed-size chunk of a file and a root hash computed
+//       from the chunk hashes, so a modified file can be rehashed one chunk at a time.
+typedef struct scfg_hash_manifest scfg_hash_manifest_t;
+
+// Note: A hash cache is a file that stores file hashes keyed by the identity, size and write time
+//       of each file. It is opened by scfg_open_hash_cache() and must be closed with scfg_close_hash_cache().
+typedef struct scfg_hash_cache scfg_hash_cache_t;
+
+typedef struct scfg_hash_cache_stats {
+    uint64_t hits; // hashes returned without reading the file
+    uint64_t misses; // hashes computed by reading the file
+} scfg_hash_cache_stats_t;
+
+// Note: An asynchronous hash reads a file with several overlapped reads in flight and hashes each chunk
+//       as soon as its read completes, so waiting for the disk overlaps with hashing. It is started by
+//       scfg_hash_file_async() and must be released with scfg_release_async_hash(), which waits for it.
+typedef struct scfg_async_hash scfg_async_hash_t;
+
+// Note: The callback is called once, on a thread pool thread, when the hash is complete. The hash is empty
+//       if it failed. The callback must not release the asynchronous hash.
+typedef void (*scfg_async_hash_callback_t)(
+    void* const _Ctx, const scfg_error_t _Err, const scfg_byte_view_t _Hash);
+
+// Note: Zero-initialized options select the defaults: three 256 KiB reads in flight and no callback.
+typedef struct scfg_async_hash_options {
+    size_t chunk_size; // number of bytes read at once, 0 selects the default
+    size_t read_count; // number of reads in flight, 0 selects the default
+    scfg_async_hash_callback_t callback; // optional, may be NULL
+    void* context; // passed unchanged to the callback
+} scfg_async_hash_options_t;
+
+// Note: Zero-initialized options select the defaults: 64 KiB chunks read through the stream.
+typedef struct scfg_file_hash_options {
+    size_t chunk_size; // number of bytes read at once, 0 selects the default
+    __bool_t bypass_stdio; // read the underlying file handle directly, skipping the stream buffer
+} scfg_file_hash_options_t;
+
+// buffer management
+_SCFG_API scfg_error_t _SCFG_CONV scfg_initialize_buffer(void* const _Buf, const scfg_buffer_type_t _Type);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_get_associated_buffer(
+    void* const _Buf, const scfg_buffer_type_t _Type, void** const _Ptr);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_get_buffer_view(
+    void* const _Buf, const scfg_buffer_type_t _Type, void* const _View);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_reserve_buffer(void* const _Buf, const scfg_buffer_type_t _Type,
+    const size_t _New_capacity, const scfg_allocator_t* const _Al);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_resize_buffer(void* const _Buf, const scfg_buffer_type_t _Type,
+    const size_t _New_size, const scfg_allocator_t* const _Al);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_resize_buffer_uninitialized(void* const _Buf,
+    const scfg_buffer_type_t _Type, const size_t _New_size, const scfg_allocator_t* const _Al);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_shrink_buffer(
+    void* const _Buf, const scfg_buffer_type_t _Type, const scfg_allocator_t* const _Al);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_append_buffer(void* const _Buf, const scfg_buffer_type_t _Type,
+    const void* const _Data, const size_t _Size, const scfg_allocator_t* const _Al);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_move_buffer(void* const _Dest, void* const _Src,
+    const scfg_buffer_type_t _Type, const scfg_allocator_t* const _Al); // both must use the same allocator
+_SCFG_API scfg_error_t _SCFG_CONV scfg_swap_buffer(
+    void* const _Left, void* const _Right, const scfg_buffer_type_t _Type);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_release_buffer(
+    void* const _Buf, const scfg_buffer_type_t _Type, const scfg_allocator_t* const _Al);
+
+// file mapping
+_SCFG_API scfg_error_t _SCFG_CONV scfg_map_file(const wchar_t* const _Path, scfg_mapped_buffer_t* const _Buf);
+
+// arena allocation
+_SCFG_API scfg_error_t _SCFG_CONV scfg_initialize_arena(scfg_arena_t* const _Arena, const size_t _Block_size);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_get_arena_allocator(
+    scfg_arena_t* const _Arena, scfg_allocator_t* const _Al);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_reset_arena(scfg_arena_t* const _Arena);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_release_arena(scfg_arena_t* const _Arena);
+
+// pool allocation
+_SCFG_API scfg_error_t _SCFG_CONV scfg_get_pool_allocator(scfg_allocator_t* const _Al);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_trim_pool_allocator(void);
+
+// hashing
+_SCFG_API __bool_t _SCFG_CONV scfg_is_valid_hash_id(const scfg_hash_id_t _Id);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_get_hash_size(const scfg_hash_id_t _Id, size_t* const _Size);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_get_hash_kernel(
+    const scfg_hash_id_t _Id, scfg_hash_kernel_t* const _Kernel);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_hash_bytes(const uint8_t* const _Data, const size_t _Size,
+    const scfg_hash_id_t _Id, scfg_byte_buffer_t* const _Buf);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_hash_utf8(const char* const _Data, const size_t _Size,
+    const scfg_hash_id_t _Id, scfg_byte_buffer_t* const _Buf);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_hash_unicode(const wchar_t* const _Data, const size_t _Size,
+    const scfg_hash_id_t _Id, scfg_byte_buffer_t* const _Buf);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_hash_file(
+    FILE* const _Stream, const size_t _Off, const scfg_hash_id_t _Id, scfg_byte_buffer_t* const _Buf);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_hash_file_with_options(FILE* const _Stream, const size_t _Off,
+    const scfg_hash_id_t _Id, const scfg_file_hash_options_t* const _Options, scfg_byte_buffer_t* const _Buf);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_hash_file_multi(FILE* const _Stream, const size_t _Off,
+    const scfg_hash_id_t* const _Ids, scfg_byte_buffer_t* const _Bufs, const size_t _Count,
+    const scfg_file_hash_options_t* const _Options); // reads the stream once, fills one buffer per hash
+_SCFG_API scfg_error_t _SCFG_CONV scfg_hash_file_range(FILE* const _Stream, const uint64_t _Off,
+    const uint64_t _Size, const scfg_hash_id_t _Id,
+    scfg_byte_buffer_t* const _Buf); // positional, may run concurrently on the same stream
+_SCFG_API scfg_error_t _SCFG_CONV scfg_hash_batch(const uint8_t* const* const _Data,
+    const size_t* const _Sizes, const size_t _Count, const scfg_hash_id_t _Id,
+    scfg_byte_buffer_t* const _Buf); // hashes are stored back to back
+_SCFG_API scfg_error_t _SCFG_CONV scfg_hash_byte_view(const scfg_byte_view_t _Data, const scfg_hash_id_t _Id,
+    uint8_t* const _Out, const size_t _Out_size, scfg_byte_view_t* const _Hash);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_hash_utf8_view(const scfg_utf8_view_t _Data, const scfg_hash_id_t _Id,
+    uint8_t* const _Out, const size_t _Out_size, scfg_byte_view_t* const _Hash);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_hash_unicode_view(const scfg_unicode_view_t _Data,
+    const scfg_hash_id_t _Id, uint8_t* const _Out, const size_t _Out_size, scfg_byte_view_t* const _Hash);
+
+// parallel hashing
+// Note: A thread count of 0 selects one thread per processor. A single input is split across threads
+//       only for BLAKE3, other hashes of a single input are computed on the calling thread.
+_SCFG_API scfg_error_t _SCFG_CONV scfg_hash_bytes_parallel(const uint8_t* const _Data, const size_t _Size,
+    const scfg_hash_id_t _Id, const size_t _Thread_count, scfg_byte_buffer_t* const _Buf);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_hash_file_parallel(const wchar_t* const _Path,
+    const scfg_hash_id_t _Id, const size_t _Thread_count, scfg_byte_buffer_t* const _Buf);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_hash_files(const wchar_t* const* const _Paths, const size_t _Count,
+    const scfg_hash_id_t _Id, const size_t _Thread_count, scfg_byte_buffer_t* const _Buf,
+    scfg_error_t* const _Errors); // hashes are stored back to back, _Errors receives one result per file
+
+// streaming hashing
+_SCFG_API scfg_error_t _SCFG_CONV scfg_create_hasher(const scfg_hash_id_t _Id, scfg_hasher_t** const _Hasher);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_update_hasher(
+    scfg_hasher_t* const _Hasher, const uint8_t* const _Data, const size_t _Size);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_finalize_hasher(
+    scfg_hasher_t* const _Hasher, scfg_byte_buffer_t* const _Buf);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_reset_hasher(scfg_hasher_t* const _Hasher);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_release_hasher(scfg_hasher_t* const _Hasher);
+
+// keyed hashing, key derivation and extendable output
+// Note: These use BLAKE3 and fill the whole buffer, so its size selects the output length. A key is 32 bytes,
+//       the context of a derived key should be a hardcoded string that is unique to the application.
+_SCFG_API scfg_error_t _SCFG_CONV scfg_hash_bytes_keyed(const uint8_t* const _Data, const size_t _Size,
+    const uint8_t* const _Key, scfg_byte_buffer_t* const _Buf);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_derive_key(const char* const _Context, const uint8_t* const _Material,
+    const size_t _Size, scfg_byte_buffer_t* const _Buf);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_hash_bytes_xof(const uint8_t* const _Data, const size_t _Size,
+    const uint64_t _Seek, scfg_byte_buffer_t* const _Buf); // _Seek is the offset into the output
+_SCFG_API scfg_error_t _SCFG_CONV scfg_create_keyed_hasher(
+    const uint8_t* const _Key, scfg_hasher_t** const _Hasher);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_create_derive_key_hasher(
+    const char* const _Context, scfg_hasher_t** const _Hasher);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_finalize_hasher_xof(scfg_hasher_t* const _Hasher, const uint64_t _Seek,
+    scfg_byte_buffer_t* const _Buf); // BLAKE3 hashers only, keyed hashers keep their key
+
+// hash manifests
+// Note: A chunk size of 0 selects 1 MiB chunks. The root is the hash of all chunk hashes stored back to back.
+//       A stored manifest is restored with scfg_load_hash_manifest(), which computes the root again.
+_SCFG_API scfg_error_t _SCFG_CONV scfg_create_hash_manifest(const wchar_t* const _Path,
+    const scfg_hash_id_t _Id, const size_t _Chunk_size, const size_t _Thread_count,
+    scfg_hash_manifest_t** const _Manifest);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_load_hash_manifest(const scfg_hash_id_t _Id, const size_t _Chunk_size,
+    const uint64_t _File_size, const uint8_t* const _Chunk_hashes, const size_t _Count,
+    const uint8_t* const _Root, scfg_hash_manifest_t** const _Manifest); // a NULL root is not checked
+_SCFG_API scfg_error_t _SCFG_CONV scfg_update_hash_manifest(scfg_hash_manifest_t* const _Manifest,
+    const wchar_t* const _Path, const uint64_t* const _Offsets, const uint64_t* const _Sizes,
+    const size_t _Count, const size_t _Thread_count); // rehashes the chunks touched by the modified ranges
+_SCFG_API scfg_error_t _SCFG_CONV scfg_verify_hash_manifest(const scfg_hash_manifest_t* const _Manifest,
+    const wchar_t* const _Path, const size_t _Thread_count, size_t* const _Mismatches);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_get_hash_manifest_root(
+    const scfg_hash_manifest_t* const _Manifest, scfg_byte_buffer_t* const _Buf);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_get_hash_manifest_info(const scfg_hash_manifest_t* const _Manifest,
+    scfg_hash_id_t* const _Id, size_t* const _Chunk_size, uint64_t* const _File_size);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_get_hash_manifest_chunks(const scfg_hash_manifest_t* const _Manifest,
+    scfg_byte_buffer_t* const _Buf, size_t* const _Count); // chunk hashes are stored back to back
+_SCFG_API scfg_error_t _SCFG_CONV scfg_release_hash_manifest(scfg_hash_manifest_t* const _Manifest);
+
+// hash cache
+// Note: A capacity of 0 selects 4096 entries, other capacities are rounded up to a power of two.
+//       The capacity of an existing cache file is kept. A null cache hashes every file.
+_SCFG_API scfg_error_t _SCFG_CONV scfg_open_hash_cache(
+    const wchar_t* const _Path, const size_t _Capacity, scfg_hash_cache_t** const _Cache);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_close_hash_cache(scfg_hash_cache_t* const _Cache);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_hash_file_cached(scfg_hash_cache_t* const _Cache, FILE* const _Stream,
+    const size_t _Off, const scfg_hash_id_t _Id, const scfg_file_hash_options_t* const _Options,
+    scfg_byte_buffer_t* const _Buf);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_get_hash_cache_stats(
+    scfg_hash_cache_t* const _Cache, scfg_hash_cache_stats_t* const _Stats);
+
+// asynchronous hashing
+// Note: The event is a Windows event handle that is signaled when the hash is complete, it is owned
+//       by the asynchronous hash. Files that cannot be read with overlapped reads use blocking reads.
+_SCFG_API scfg_error_t _SCFG_CONV scfg_hash_file_async(const wchar_t* const _Path, const scfg_hash_id_t _Id,
+    const scfg_async_hash_options_t* const _Options, scfg_async_hash_t** const _Hash);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_get_async_hash_event(
+    scfg_async_hash_t* const _Hash, void** const _Event);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_wait_async_hash(
+    scfg_async_hash_t* const _Hash, scfg_byte_buffer_t* const _Buf); // returns the result of the hash
+_SCFG_API scfg_error_t _SCFG_CONV scfg_release_async_hash(scfg_async_hash_t* const _Hash);
+
+// integer packing
+_SCFG_API scfg_error_t _SCFG_CONV scfg_pack_uint32(const uint8_t* const _Bytes, uint32_t* const _Val);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_unpack_uint32(uint8_t* const _Bytes, const uint32_t _Val);
+
+// unicode conversion
+_SCFG_API scfg_error_t _SCFG_CONV scfg_unicode_to_utf8_required_buffer_size(
+    const wchar_t* _Data, size_t _Data_size, size_t* const _Buf_size);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_utf8_to_unicode_required_buffer_size(
+    const char* _Data, size_t _Data_size, size_t* const _Buf_size);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_unicode_to_utf8(
+    const wchar_t* _Data, size_t _Size, scfg_utf8_buffer_t* const _Buf);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_utf8_to_unicode(
+    const char* _Data, size_t _Size, scfg_unicode_buffer_t* const _Buf);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_unicode_view_to_utf8(const scfg_unicode_view_t _Data,
+    char* const _Out, const size_t _Out_size, scfg_utf8_view_t* const _Result);
+_SCFG_API scfg_error_t _SCFG_CONV scfg_utf8_view_to_unicode(const scfg_utf8_view_t _Data,
+    wchar_t* const _Out, const size_t _Out_size, scfg_unicode_view_t* const _Result);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif // __cplusplus
+#endif // _SCFG_H_
\ No newline at end of file
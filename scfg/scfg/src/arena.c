@@ -0,0 +1,159 @@
+// arena.c
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <inc/scfg.h>
+#include <scfgpch.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define _DEFAULT_ARENA_BLOCK_SIZE 65536 // 64 KiB
+
+struct scfg_arena_block {
+    struct scfg_arena_block* _Next; // previously used block
+    size_t _Size; // number of bytes that follow the header
+    size_t _Used; // number of bytes already handed out
+};
+
+inline uint8_t* _SCFG_CONV _Get_arena_block_data(struct scfg_arena_block* const _Block) {
+    return (uint8_t*) (_Block + 1); // data follows the header
+}
+
+inline size_t _SCFG_CONV _Align_arena_offset(
+    struct scfg_arena_block* const _Block, const size_t _Off, const size_t _Align) {
+    const uintptr_t _Addr = (uintptr_t) (_Get_arena_block_data(_Block) + _Off);
+    return _Off + ((_Align - (_Addr & (_Align - 1))) & (_Align - 1));
+}
+
+inline void _SCFG_CONV _Release_arena_blocks(struct scfg_arena_block* _Block) {
+    while (_Block) {
+        struct scfg_arena_block* const _Next = _Block->_Next;
+        free(_Block);
+        _Block = _Next;
+    }
+}
+
+inline struct scfg_arena_block* _SCFG_CONV _Push_arena_block(
+    scfg_arena_t* const _Arena, const size_t _Size, const size_t _Align) {
+    // Note: Reserve enough space to align the first allocation in the new block.
+    if (_Size > SIZE_MAX - sizeof(struct scfg_arena_block) - _Align) { // the block size would overflow
+        return NULL;
+    }
+
+    const size_t _Block_size              = _SCFG_MAX(_Arena->_Block_size, _Size + _Align);
+    struct scfg_arena_block* const _Block = (struct scfg_arena_block*) malloc(
+        sizeof(struct scfg_arena_block) + _Block_size);
+    if (!_Block) {
+        return NULL;
+    }
+
+    _Block->_Next = _Arena->_Head;
+    _Block->_Size = _Block_size;
+    _Block->_Used = 0;
+    _Arena->_Head = _Block;
+    return _Block;
+}
+
+static void* _Arena_allocate(void* const _Ctx, const size_t _Size, const size_t _Align) {
+    scfg_arena_t* const _Arena      = (scfg_arena_t*) _Ctx;
+    struct scfg_arena_block* _Block = _Arena->_Head;
+    size_t _Off                     = 0;
+    if (_Block) { // try to bump the pointer in the current block
+        _Off = _Align_arena_offset(_Block, _Block->_Used, _Align);
+    }
+
+    if (!_Block || _Off > _Block->_Size || _Size > _Block->_Size - _Off) { // the current block is full
+        _Block = _Push_arena_block(_Arena, _Size, _Align);
+        if (!_Block) {
+            return NULL;
+        }
+
+        _Off = _Align_arena_offset(_Block, 0, _Align);
+    }
+
+    _Block->_Used = _Off + _Size;
+    return _Get_arena_block_data(_Block) + _Off;
+}
+
+static void _Arena_deallocate(void* const _Ctx, void* const _Ptr, const size_t _Size) {
+    // Note: Memory is released all at once by scfg_reset_arena() or scfg_release_arena().
+    (void) _Ctx;
+    (void) _Ptr;
+    (void) _Size;
+}
+
+static void* _Arena_reallocate(void* const _Ctx, void* const _Ptr, const size_t _Old_size,
+    const size_t _New_size, const size_t _Align) {
+    scfg_arena_t* const _Arena            = (scfg_arena_t*) _Ctx;
+    struct scfg_arena_block* const _Block = _Arena->_Head;
+    if (_Block && (uint8_t*) _Ptr + _Old_size == _Get_arena_block_data(_Block) + _Block->_Used) {
+        // Note: The block was the most recent allocation, try to resize it in-place.
+        const size_t _Off = (size_t) ((uint8_t*) _Ptr - _Get_arena_block_data(_Block));
+        if (_New_size <= _Block->_Size - _Off) {
+            _Block->_Used = _Off + _New_size;
+            return _Ptr;
+        }
+    }
+
+    void* const _New_ptr = _Arena_allocate(_Ctx, _New_size, _Align);
+    if (!_New_ptr) { // the old block is still valid
+        return NULL;
+    }
+
+    memcpy(_New_ptr, _Ptr, _SCFG_MIN(_Old_size, _New_size));
+    return _New_ptr;
+}
+
+scfg_error_t _SCFG_CONV scfg_initialize_arena(scfg_arena_t* const _Arena, const size_t _Block_size) {
+    if (!_Arena) {
+        return scfg_error_invalid_arena;
+    }
+
+    _Arena->_Head       = NULL; // allocate the first block lazily
+    _Arena->_Block_size = _Block_size != 0 ? _Block_size : _DEFAULT_ARENA_BLOCK_SIZE;
+    return scfg_error_success;
+}
+
+scfg_error_t _SCFG_CONV scfg_get_arena_allocator(scfg_arena_t* const _Arena, scfg_allocator_t* const _Al) {
+    if (!_Arena) {
+        return scfg_error_invalid_arena;
+    }
+
+    if (!_Al) {
+        return scfg_error_invalid_allocator;
+    }
+
+    _Al->version    = _SCFG_ALLOCATOR_VERSION;
+    _Al->context    = _Arena;
+    _Al->allocate   = _Arena_allocate;
+    _Al->deallocate = _Arena_deallocate;
+    _Al->reallocate = _Arena_reallocate;
+    return scfg_error_success;
+}
+
+scfg_error_t _SCFG_CONV scfg_reset_arena(scfg_arena_t* const _Arena) {
+    if (!_Arena) {
+        return scfg_error_invalid_arena;
+    }
+
+    if (_Arena->_Head) { // keep the most recent block, so that the arena can be reused without a malloc()
+        _Release_arena_blocks(_Arena->_Head->_Next);
+        _Arena->_Head->_Next = NULL;
+        _Arena->_Head->_Used = 0;
+    }
+
+    return scfg_error_success;
+}
+
+scfg_error_t _SCFG_CONV scfg_release_arena(scfg_arena_t* const _Arena) {
+    if (!_Arena) {
+        return scfg_error_invalid_arena;
+    }
+
+    _Release_arena_blocks(_Arena->_Head);
+    _Arena->_Head = NULL;
+    return scfg_error_success;
+}
\ No newline at end of file
@@ -0,0 +1,348 @@
+// async.c
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <hash.h>
+#include <inc/scfg.h>
+#include <scfgpch.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define _DEFAULT_ASYNC_CHUNK_SIZE 262144 // 256 KiB
+#define _DEFAULT_ASYNC_READ_COUNT 3 // one chunk is hashed while two are read
+#define _MAX_ASYNC_READ_COUNT     64
+
+struct _Async_read {
+    OVERLAPPED _Overlapped; // the event is signaled when the read completes
+    uint8_t* _Chunk;
+    DWORD _Size; // number of requested bytes, 0 if no read is pending
+};
+
+// Note: Reads are issued and completed in file order, one per chunk. A completed chunk is hashed
+//       and then reused for the next read, so the other reads stay in flight while it is hashed.
+struct scfg_async_hash {
+    scfg_hash_id_t _Id;
+    HANDLE _File; // NULL once the hash is complete
+    __bool_t _Blocking; // the file could not be opened for overlapped reads
+    uint64_t _File_size;
+    uint64_t _Next_off; // the offset of the next read
+    scfg_hasher_t* _Hasher; // NULL if the file is read with blocking reads
+    struct _Async_read* _Reads; // NULL if the file is read with blocking reads
+    size_t _Read_count;
+    uint8_t* _Chunks; // released once the hash is complete
+    size_t _Chunk_size;
+    PTP_WORK _Work; // NULL if the hash was computed on the calling thread
+    HANDLE _Done; // signaled once the hash is complete
+    scfg_async_hash_callback_t _Callback;
+    void* _Ctx;
+    scfg_error_t _Err;
+    scfg_byte_buffer_t _Result;
+};
+
+inline scfg_error_t _SCFG_CONV _Open_async_file(const wchar_t* const _Path, scfg_async_hash_t* const _Hash) {
+    if (!_Path) {
+        return scfg_error_invalid_stream;
+    }
+
+    // Note: Some files and devices cannot be opened for overlapped reads, those are read with blocking reads.
+    _Hash->_File = CreateFileW(_Path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (_Hash->_File == INVALID_HANDLE_VALUE) {
+        _Hash->_Blocking = 1;
+        _Hash->_File     = CreateFileW(_Path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+            FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if (_Hash->_File == INVALID_HANDLE_VALUE) {
+            _Hash->_File = NULL;
+            return scfg_error_invalid_stream;
+        }
+    }
+
+    LARGE_INTEGER _Size;
+    if (!GetFileSizeEx(_Hash->_File, &_Size)) {
+        return scfg_error_invalid_stream;
+    }
+
+    _Hash->_File_size = (uint64_t) _Size.QuadPart;
+    return scfg_error_success;
+}
+
+inline scfg_error_t _SCFG_CONV _Prepare_async_reads(scfg_async_hash_t* const _Hash) {
+    const size_t _Chunk_count = _Hash->_Blocking ? 1 : _Hash->_Read_count;
+    if (_Hash->_Chunk_size > SIZE_MAX / _Chunk_count) {
+        return scfg_error_not_enough_memory;
+    }
+
+    _Hash->_Chunks = (uint8_t*) malloc(_Chunk_count * _Hash->_Chunk_size);
+    if (!_Hash->_Chunks) {
+        return scfg_error_not_enough_memory;
+    }
+
+    if (_Hash->_Blocking) { // a single chunk, no events
+        return scfg_error_success;
+    }
+
+    _Hash->_Reads = (struct _Async_read*) malloc(_Hash->_Read_count * sizeof(struct _Async_read));
+    if (!_Hash->_Reads) {
+        return scfg_error_not_enough_memory;
+    }
+
+    memset(_Hash->_Reads, 0, _Hash->_Read_count * sizeof(struct _Async_read));
+    for (size_t _Idx = 0; _Idx < _Hash->_Read_count; ++_Idx) {
+        struct _Async_read* const _Read = &_Hash->_Reads[_Idx];
+        _Read->_Chunk                   = _Hash->_Chunks + _Idx * _Hash->_Chunk_size;
+        _Read->_Overlapped.hEvent       = CreateEventW(NULL, TRUE, FALSE, NULL); // manual-reset
+        if (!_Read->_Overlapped.hEvent) {
+            return scfg_error_general_failure;
+        }
+    }
+
+    return scfg_create_hasher(_Hash->_Id, &_Hash->_Hasher);
+}
+
+inline scfg_error_t _SCFG_CONV _Issue_async_read(
+    scfg_async_hash_t* const _Hash, struct _Async_read* const _Read) {
+    const uint64_t _Left = _Hash->_File_size - _Hash->_Next_off;
+    _Read->_Size         = (DWORD) _SCFG_MIN((uint64_t) _Hash->_Chunk_size, _Left);
+    if (_Read->_Size == 0) { // no more data
+        return scfg_error_success;
+    }
+
+    _Read->_Overlapped.Offset     = (DWORD) _Hash->_Next_off;
+    _Read->_Overlapped.OffsetHigh = (DWORD) (_Hash->_Next_off >> 32);
+    _Hash->_Next_off += _Read->_Size;
+    if (!ReadFile(_Hash->_File, _Read->_Chunk, _Read->_Size, NULL, &_Read->_Overlapped)
+        && GetLastError() != ERROR_IO_PENDING) {
+        _Read->_Size = 0; // nothing to wait for
+        return scfg_error_invalid_stream;
+    }
+
+    return scfg_error_success;
+}
+
+inline scfg_error_t _SCFG_CONV _Complete_async_read(
+    scfg_async_hash_t* const _Hash, struct _Async_read* const _Read) {
+    DWORD _Read_size;
+    const BOOL _Succeeded = GetOverlappedResult(_Hash->_File, &_Read->_Overlapped, &_Read_size, TRUE);
+    const DWORD _Size     = _Read->_Size;
+    _Read->_Size          = 0;
+    if (!_Succeeded || _Read_size != _Size) { // the file was truncated while it was read
+        return scfg_error_invalid_stream;
+    }
+
+    return scfg_update_hasher(_Hash->_Hasher, _Read->_Chunk, _Read_size);
+}
+
+inline void _SCFG_CONV _Cancel_async_reads(scfg_async_hash_t* const _Hash) {
+    // Note: A chunk must not be released while a read into it is still pending.
+    CancelIoEx(_Hash->_File, NULL);
+    DWORD _Read_size;
+    for (size_t _Idx = 0; _Idx < _Hash->_Read_count; ++_Idx) {
+        if (_Hash->_Reads[_Idx]._Size != 0) {
+            GetOverlappedResult(_Hash->_File, &_Hash->_Reads[_Idx]._Overlapped, &_Read_size, TRUE);
+            _Hash->_Reads[_Idx]._Size = 0;
+        }
+    }
+}
+
+inline scfg_error_t _SCFG_CONV _Hash_overlapped(scfg_async_hash_t* const _Hash) {
+    scfg_error_t _Err = scfg_error_success;
+    for (size_t _Idx = 0; _Err == scfg_error_success && _Idx < _Hash->_Read_count; ++_Idx) {
+        _Err = _Issue_async_read(_Hash, &_Hash->_Reads[_Idx]);
+    }
+
+    // Note: Once a read is not issued, no later read is issued either, so an idle read ends the loop.
+    size_t _Idx = 0;
+    while (_Err == scfg_error_success && _Hash->_Reads[_Idx]._Size != 0) {
+        _Err = _Complete_async_read(_Hash, &_Hash->_Reads[_Idx]);
+        if (_Err == scfg_error_success) {
+            _Err = _Issue_async_read(_Hash, &_Hash->_Reads[_Idx]); // reuse the chunk
+        }
+
+        _Idx = (_Idx + 1) % _Hash->_Read_count;
+    }
+
+    if (_Err != scfg_error_success) {
+        _Cancel_async_reads(_Hash);
+        return _Err;
+    }
+
+    return scfg_finalize_hasher(_Hash->_Hasher, &_Hash->_Result);
+}
+
+inline scfg_error_t _SCFG_CONV _Hash_blocking(scfg_async_hash_t* const _Hash) {
+    uint8_t* _Ptr;
+    const scfg_error_t _Err = scfg_get_associated_buffer(&_Hash->_Result, scfg_buffer_type_byte, &_Ptr);
+    if (_Err != scfg_error_success) {
+        return _Err;
+    }
+
+    return _Hash_region(_Hash->_File, 0, _Hash->_File_size, _Hash->_Id, _Hash->_Chunks,
+        _Hash->_Chunk_size, _Ptr);
+}
+
+inline void _SCFG_CONV _Run_async_hash(scfg_async_hash_t* const _Hash) {
+    _Hash->_Err = _Hash->_Blocking ? _Hash_blocking(_Hash) : _Hash_overlapped(_Hash);
+    CloseHandle(_Hash->_File); // the file and the chunks are not needed anymore
+    _Hash->_File = NULL;
+    free(_Hash->_Chunks);
+    _Hash->_Chunks = NULL;
+    if (_Hash->_Callback) {
+        scfg_byte_view_t _View = {NULL, 0}; // empty if the hash failed
+        if (_Hash->_Err == scfg_error_success) {
+            scfg_get_buffer_view(&_Hash->_Result, scfg_buffer_type_byte, &_View);
+        }
+
+        _Hash->_Callback(_Hash->_Ctx, _Hash->_Err, _View);
+    }
+
+    SetEvent(_Hash->_Done);
+}
+
+static void CALLBACK _Async_hash_worker(PTP_CALLBACK_INSTANCE _Instance, void* const _Ctx, PTP_WORK _Work) {
+    (void) _Instance;
+    (void) _Work;
+    _Run_async_hash((scfg_async_hash_t*) _Ctx);
+}
+
+inline void _SCFG_CONV _Release_async_hash(scfg_async_hash_t* const _Hash) {
+    if (_Hash->_Reads) {
+        for (size_t _Idx = 0; _Idx < _Hash->_Read_count; ++_Idx) {
+            if (_Hash->_Reads[_Idx]._Overlapped.hEvent) {
+                CloseHandle(_Hash->_Reads[_Idx]._Overlapped.hEvent);
+            }
+        }
+
+        free(_Hash->_Reads);
+    }
+
+    if (_Hash->_Hasher) {
+        scfg_release_hasher(_Hash->_Hasher);
+    }
+
+    if (_Hash->_File) {
+        CloseHandle(_Hash->_File);
+    }
+
+    if (_Hash->_Done) {
+        CloseHandle(_Hash->_Done);
+    }
+
+    free(_Hash->_Chunks);
+    scfg_release_buffer(&_Hash->_Result, scfg_buffer_type_byte, NULL);
+    free(_Hash);
+}
+
+scfg_error_t _SCFG_CONV scfg_hash_file_async(const wchar_t* const _Path, const scfg_hash_id_t _Id,
+    const scfg_async_hash_options_t* const _Options, scfg_async_hash_t** const _Hash) {
+    if (!_Hash) {
+        return scfg_error_invalid_async_hash;
+    }
+
+    const size_t _Hash_size = _Get_hash_size(_Id);
+    if (_Hash_size == 0) {
+        return scfg_error_unsupported_hash;
+    }
+
+    scfg_async_hash_t* const _New_hash = (scfg_async_hash_t*) malloc(sizeof(scfg_async_hash_t));
+    if (!_New_hash) {
+        return scfg_error_not_enough_memory;
+    }
+
+    memset(_New_hash, 0, sizeof(scfg_async_hash_t));
+    const size_t _Chunk_size = _Options && _Options->chunk_size != 0 ? _Options->chunk_size
+                                                                     : _DEFAULT_ASYNC_CHUNK_SIZE;
+    const size_t _Read_count = _Options && _Options->read_count != 0 ? _Options->read_count
+                                                                     : _DEFAULT_ASYNC_READ_COUNT;
+    _New_hash->_Id           = _Id;
+    _New_hash->_Chunk_size   = _SCFG_MIN(_Chunk_size, (size_t) MAXDWORD);
+    _New_hash->_Read_count   = _SCFG_MIN(_Read_count, (size_t) _MAX_ASYNC_READ_COUNT);
+    _New_hash->_Callback     = _Options ? _Options->callback : NULL;
+    _New_hash->_Ctx          = _Options ? _Options->context : NULL;
+    scfg_error_t _Err        = scfg_initialize_buffer(&_New_hash->_Result, scfg_buffer_type_byte);
+    if (_Err == scfg_error_success) {
+        _Err = scfg_resize_buffer(&_New_hash->_Result, scfg_buffer_type_byte, _Hash_size, NULL);
+    }
+
+    if (_Err == scfg_error_success) {
+        _Err = _Open_async_file(_Path, _New_hash);
+    }
+
+    if (_Err == scfg_error_success) {
+        _Err = _Prepare_async_reads(_New_hash);
+    }
+
+    if (_Err == scfg_error_success) {
+        _New_hash->_Done = CreateEventW(NULL, TRUE, FALSE, NULL); // manual-reset, stays signaled
+        if (!_New_hash->_Done) {
+            _Err = scfg_error_general_failure;
+        }
+    }
+
+    if (_Err != scfg_error_success) {
+        _Release_async_hash(_New_hash);
+        return _Err;
+    }
+
+    // Note: Without a work object, the hash is computed before this function returns.
+    _New_hash->_Work = CreateThreadpoolWork(_Async_hash_worker, _New_hash, NULL);
+    if (_New_hash->_Work) {
+        SubmitThreadpoolWork(_New_hash->_Work);
+    } else {
+        _Run_async_hash(_New_hash);
+    }
+
+    *_Hash = _New_hash;
+    return scfg_error_success;
+}
+
+scfg_error_t _SCFG_CONV scfg_get_async_hash_event(scfg_async_hash_t* const _Hash, void** const _Event) {
+    if (!_Hash) {
+        return scfg_error_invalid_async_hash;
+    }
+
+    if (!_Event) {
+        return scfg_error_invalid_data;
+    }
+
+    *_Event = _Hash->_Done;
+    return scfg_error_success;
+}
+
+scfg_error_t _SCFG_CONV scfg_wait_async_hash(scfg_async_hash_t* const _Hash, scfg_byte_buffer_t* const _Buf) {
+    if (!_Hash) {
+        return scfg_error_invalid_async_hash;
+    }
+
+    WaitForSingleObject(_Hash->_Done, INFINITE);
+    if (_Hash->_Err != scfg_error_success) {
+        return _Hash->_Err;
+    }
+
+    uint8_t* _Ptr;
+    const scfg_error_t _Err = _Get_hash_buffer(_Buf, _Hash->_Result._Size, &_Ptr);
+    if (_Err != scfg_error_success) {
+        return _Err;
+    }
+
+    scfg_byte_view_t _View;
+    scfg_get_buffer_view(&_Hash->_Result, scfg_buffer_type_byte, &_View);
+    memcpy(_Ptr, _View.data, _View.size);
+    return scfg_error_success;
+}
+
+scfg_error_t _SCFG_CONV scfg_release_async_hash(scfg_async_hash_t* const _Hash) {
+    if (!_Hash) {
+        return scfg_error_invalid_async_hash;
+    }
+
+    if (_Hash->_Work) { // wait for the hash to complete
+        WaitForThreadpoolWorkCallbacks(_Hash->_Work, FALSE);
+        CloseThreadpoolWork(_Hash->_Work);
+    }
+
+    _Release_async_hash(_Hash);
+    return scfg_error_success;
+}
\ No newline at end of file
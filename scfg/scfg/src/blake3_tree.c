@@ -0,0 +1,469 @@
+// blake3_tree.c
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <blake3.h>
+#include <blake3_tree.h>
+#include <inc/scfg.h>
+#include <parallel.h>
+#include <scfgpch.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define _BLAKE3_CHUNK_START 1
+#define _BLAKE3_CHUNK_END   2
+#define _BLAKE3_PARENT      4
+#define _BLAKE3_ROOT        8
+
+#define _BLAKE3_SUBTREE_SIZE   1048576 // 1 MiB, must be a power of two multiple of BLAKE3_CHUNK_LEN
+#define _BLAKE3_SUBTREE_CHUNKS (_BLAKE3_SUBTREE_SIZE / BLAKE3_CHUNK_LEN)
+
+#define _BLAKE3_BATCH_SIZE 64 // messages passed to blake3_hash_many() at once
+
+// Note: The bundled BLAKE3 library does not expose subtree hashing. Each subtree is hashed with
+//       blake3_hasher_update(), which keeps the SIMD paths, and the tree is finished here the same way
+//       blake3_hasher_finalize() would, except that only the final compression gets the ROOT flag.
+//       This relies on the blake3_hasher layout of BLAKE3 1.3.1.
+
+// Note: blake3_hash_many() is not declared by blake3.h, but the bundled library exports it. It compresses
+//       _Count inputs of _Blocks whole blocks each, using the widest SIMD kernel of the processor.
+void blake3_hash_many(const uint8_t* const* _Inputs, size_t _Count, size_t _Blocks, const uint32_t _Key[8],
+    uint64_t _Counter, bool _Increment_counter, uint8_t _Flags, uint8_t _Flags_start, uint8_t _Flags_end,
+    uint8_t* _Out);
+
+static const uint32_t _Blake3_iv[8] = {
+    0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19};
+
+static const uint8_t _Blake3_schedule[7][16] = {
+    {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+    {2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8},
+    {3, 4, 10, 12, 13, 2, 7, 14, 6, 5, 9, 0, 11, 15, 8, 1},
+    {10, 7, 12, 9, 14, 3, 13, 15, 4, 0, 11, 2, 5, 8, 1, 6},
+    {12, 13, 9, 11, 15, 10, 14, 8, 7, 2, 5, 3, 0, 1, 6, 4},
+    {9, 14, 11, 5, 8, 12, 15, 1, 13, 3, 0, 10, 2, 6, 4, 7},
+    {11, 15, 5, 0, 1, 9, 8, 6, 14, 10, 2, 12, 3, 4, 7, 13}};
+
+struct _Blake3_output { // a compression that has not been performed yet
+    uint32_t _Cv[8];
+    uint8_t _Block[BLAKE3_BLOCK_LEN];
+    uint64_t _Counter;
+    uint8_t _Block_len;
+    uint8_t _Flags;
+};
+
+// Note: Subtrees are taken either from memory or from a file. Each worker reads a file through its own
+//       handle with positional reads, so only one subtree per worker is held in memory at a time.
+struct _Blake3_job {
+    const blake3_hasher* _Base; // initialized hasher, provides the key and flags
+    const uint8_t* _Data; // NULL if the subtrees are read from _File
+    HANDLE _File;
+    size_t _Count; // number of full subtrees
+    volatile LONG _Next; // the next subtree to be hashed
+    volatile LONG _Err; // the first error reported by a worker
+    uint8_t* _Cvs; // chaining value of each full subtree
+};
+
+inline uint32_t _SCFG_CONV _Rotate_right(const uint32_t _Val, const int _Count) {
+    return (_Val >> _Count) | (_Val << (32 - _Count));
+}
+
+inline uint32_t _SCFG_CONV _Load_word(const uint8_t* const _Bytes) {
+    return (uint32_t) _Bytes[0] | ((uint32_t) _Bytes[1] << 8) | ((uint32_t) _Bytes[2] << 16)
+         | ((uint32_t) _Bytes[3] << 24);
+}
+
+inline void _SCFG_CONV _Store_words(const uint32_t* const _Words, uint8_t* const _Bytes) {
+    for (size_t _Idx = 0; _Idx < 8; ++_Idx) { // little-endian
+        _Bytes[_Idx * 4]     = (uint8_t) _Words[_Idx];
+        _Bytes[_Idx * 4 + 1] = (uint8_t) (_Words[_Idx] >> 8);
+        _Bytes[_Idx * 4 + 2] = (uint8_t) (_Words[_Idx] >> 16);
+        _Bytes[_Idx * 4 + 3] = (uint8_t) (_Words[_Idx] >> 24);
+    }
+}
+
+inline size_t _SCFG_CONV _Count_bits(uint64_t _Val) {
+    size_t _Count = 0;
+    for (; _Val != 0; _Val &= _Val - 1) {
+        ++_Count;
+    }
+
+    return _Count;
+}
+
+inline void _SCFG_CONV _Blake3_mix(uint32_t* const _State, const size_t _A, const size_t _B, const size_t _C,
+    const size_t _D, const uint32_t _X, const uint32_t _Y) {
+    _State[_A] = _State[_A] + _State[_B] + _X;
+    _State[_D] = _Rotate_right(_State[_D] ^ _State[_A], 16);
+    _State[_C] = _State[_C] + _State[_D];
+    _State[_B] = _Rotate_right(_State[_B] ^ _State[_C], 12);
+    _State[_A] = _State[_A] + _State[_B] + _Y;
+    _State[_D] = _Rotate_right(_State[_D] ^ _State[_A], 8);
+    _State[_C] = _State[_C] + _State[_D];
+    _State[_B] = _Rotate_right(_State[_B] ^ _State[_C], 7);
+}
+
+inline void _SCFG_CONV _Blake3_compress(
+    const struct _Blake3_output* const _Output, const uint8_t _Extra_flags, uint32_t* const _Cv) {
+    uint32_t _Msg[16];
+    for (size_t _Idx = 0; _Idx < 16; ++_Idx) {
+        _Msg[_Idx] = _Load_word(_Output->_Block + _Idx * 4);
+    }
+
+    uint32_t _State[16];
+    memcpy(_State, _Output->_Cv, sizeof(_Output->_Cv));
+    memcpy(_State + 8, _Blake3_iv, 4 * sizeof(uint32_t));
+    _State[12] = (uint32_t) _Output->_Counter;
+    _State[13] = (uint32_t) (_Output->_Counter >> 32);
+    _State[14] = _Output->_Block_len;
+    _State[15] = (uint32_t) (_Output->_Flags | _Extra_flags);
+    for (size_t _Round = 0; _Round < 7; ++_Round) {
+        const uint8_t* const _Sched = _Blake3_schedule[_Round];
+        _Blake3_mix(_State, 0, 4, 8, 12, _Msg[_Sched[0]], _Msg[_Sched[1]]);
+        _Blake3_mix(_State, 1, 5, 9, 13, _Msg[_Sched[2]], _Msg[_Sched[3]]);
+        _Blake3_mix(_State, 2, 6, 10, 14, _Msg[_Sched[4]], _Msg[_Sched[5]]);
+        _Blake3_mix(_State, 3, 7, 11, 15, _Msg[_Sched[6]], _Msg[_Sched[7]]);
+        _Blake3_mix(_State, 0, 5, 10, 15, _Msg[_Sched[8]], _Msg[_Sched[9]]);
+        _Blake3_mix(_State, 1, 6, 11, 12, _Msg[_Sched[10]], _Msg[_Sched[11]]);
+        _Blake3_mix(_State, 2, 7, 8, 13, _Msg[_Sched[12]], _Msg[_Sched[13]]);
+        _Blake3_mix(_State, 3, 4, 9, 14, _Msg[_Sched[14]], _Msg[_Sched[15]]);
+    }
+
+    for (size_t _Idx = 0; _Idx < 8; ++_Idx) {
+        _Cv[_Idx] = _State[_Idx] ^ _State[_Idx + 8];
+    }
+}
+
+inline void _SCFG_CONV _Get_chaining_value(const struct _Blake3_output* const _Output, uint8_t* const _Cv) {
+    uint32_t _Words[8];
+    _Blake3_compress(_Output, 0, _Words);
+    _Store_words(_Words, _Cv);
+}
+
+inline void _SCFG_CONV _Get_chunk_output(
+    const blake3_chunk_state* const _Chunk, struct _Blake3_output* const _Output) {
+    memcpy(_Output->_Cv, _Chunk->cv, sizeof(_Chunk->cv));
+    memcpy(_Output->_Block, _Chunk->buf, BLAKE3_BLOCK_LEN);
+    _Output->_Counter   = _Chunk->chunk_counter;
+    _Output->_Block_len = _Chunk->buf_len;
+    _Output->_Flags     = _Chunk->flags | _BLAKE3_CHUNK_END;
+    if (_Chunk->blocks_compressed == 0) { // the chunk consists of a single block
+        _Output->_Flags |= _BLAKE3_CHUNK_START;
+    }
+}
+
+inline void _SCFG_CONV _Get_parent_block_output(
+    const blake3_hasher* const _Base, const uint8_t* const _Block, struct _Blake3_output* const _Output) {
+    memcpy(_Output->_Cv, _Base->key, sizeof(_Base->key));
+    memcpy(_Output->_Block, _Block, BLAKE3_BLOCK_LEN); // left and right chaining values
+    _Output->_Counter   = 0;
+    _Output->_Block_len = BLAKE3_BLOCK_LEN;
+    _Output->_Flags     = _Base->chunk.flags | _BLAKE3_PARENT;
+}
+
+inline void _SCFG_CONV _Get_parent_output(const blake3_hasher* const _Base, const uint8_t* const _Left_cv,
+    const struct _Blake3_output* const _Right, struct _Blake3_output* const _Output) {
+    uint8_t _Block[BLAKE3_BLOCK_LEN];
+    memcpy(_Block, _Left_cv, BLAKE3_OUT_LEN);
+    _Get_chaining_value(_Right, _Block + BLAKE3_OUT_LEN); // _Right may alias _Output
+    _Get_parent_block_output(_Base, _Block, _Output);
+}
+
+inline void _SCFG_CONV _Hash_subtree(const blake3_hasher* const _Base, const uint8_t* const _Data,
+    const size_t _Size, const uint64_t _First_chunk, struct _Blake3_output* const _Output) {
+    // Note: The hasher expects one stacked chaining value per set bit of its chunk counter. The subtrees
+    //       to the left are represented by placeholders, which are never merged because _Size does not
+    //       exceed _BLAKE3_SUBTREE_SIZE and _First_chunk is a multiple of _BLAKE3_SUBTREE_CHUNKS.
+    blake3_hasher _Hasher       = *_Base;
+    const size_t _Placeholders  = _Count_bits(_First_chunk);
+    _Hasher.chunk.chunk_counter = _First_chunk;
+    _Hasher.cv_stack_len        = (uint8_t) _Placeholders;
+    blake3_hasher_update(&_Hasher, _Data, _Size);
+    size_t _Idx = _Hasher.cv_stack_len;
+    if (_Hasher.chunk.blocks_compressed > 0 || _Hasher.chunk.buf_len > 0) {
+        _Get_chunk_output(&_Hasher.chunk, _Output);
+    } else { // the input ended on a subtree boundary, the top two chaining values form the output
+        _Idx -= 2;
+        _Get_parent_block_output(_Base, _Hasher.cv_stack + _Idx * BLAKE3_OUT_LEN, _Output);
+    }
+
+    for (; _Idx > _Placeholders; --_Idx) {
+        _Get_parent_output(_Base, _Hasher.cv_stack + (_Idx - 1) * BLAKE3_OUT_LEN, _Output, _Output);
+    }
+}
+
+inline scfg_error_t _SCFG_CONV _Read_subtree(
+    const HANDLE _Handle, uint64_t _Off, size_t _Size, uint8_t* _Buf) {
+    DWORD _Read; // read bytes
+    while (_Size > 0) { // _Size never exceeds _BLAKE3_SUBTREE_SIZE
+        OVERLAPPED _Overlapped = {0};
+        _Overlapped.Offset     = (DWORD) _Off;
+        _Overlapped.OffsetHigh = (DWORD) (_Off >> 32);
+        if (!ReadFile(_Handle, _Buf, (DWORD) _Size, &_Read, &_Overlapped) || _Read == 0) {
+            return scfg_error_invalid_stream; // the file was truncated
+        }
+
+        _Buf += _Read;
+        _Off += _Read;
+        _Size -= _Read;
+    }
+
+    return scfg_error_success;
+}
+
+static void _Run_blake3_job(void* const _Ctx) {
+    struct _Blake3_job* const _Job = (struct _Blake3_job*) _Ctx;
+    uint8_t* _Buf                  = NULL;
+    HANDLE _Handle                 = INVALID_HANDLE_VALUE;
+    scfg_error_t _Err              = scfg_error_success;
+    if (_Job->_File) {
+        _Buf    = (uint8_t*) malloc(_BLAKE3_SUBTREE_SIZE);
+        _Handle = ReOpenFile(_Job->_File, GENERIC_READ, FILE_SHARE_READ, 0);
+        if (!_Buf) {
+            _Err = scfg_error_not_enough_memory;
+        } else if (_Handle == INVALID_HANDLE_VALUE) {
+            _Err = scfg_error_invalid_stream;
+        }
+    }
+
+    struct _Blake3_output _Output;
+    while (_Err == scfg_error_success && _Job->_Err == scfg_error_success) {
+        const size_t _Idx = (size_t) (InterlockedIncrement(&_Job->_Next) - 1);
+        if (_Idx >= _Job->_Count) { // no more subtrees
+            break;
+        }
+
+        const uint8_t* _Subtree = _Buf;
+        if (_Job->_File) {
+            _Err = _Read_subtree(_Handle, (uint64_t) _Idx * _BLAKE3_SUBTREE_SIZE, _BLAKE3_SUBTREE_SIZE, _Buf);
+            if (_Err != scfg_error_success) {
+                break;
+            }
+        } else {
+            _Subtree = _Job->_Data + _Idx * _BLAKE3_SUBTREE_SIZE;
+        }
+
+        _Hash_subtree(_Job->_Base, _Subtree, _BLAKE3_SUBTREE_SIZE, (uint64_t) _Idx * _BLAKE3_SUBTREE_CHUNKS,
+            &_Output);
+        _Get_chaining_value(&_Output, _Job->_Cvs + _Idx * BLAKE3_OUT_LEN);
+    }
+
+    if (_Err != scfg_error_success) { // keep the first error
+        InterlockedCompareExchange(&_Job->_Err, (LONG) _Err, (LONG) scfg_error_success);
+    }
+
+    if (_Handle != INVALID_HANDLE_VALUE) {
+        CloseHandle(_Handle);
+    }
+
+    free(_Buf);
+}
+
+inline scfg_error_t _SCFG_CONV _Hash_blake3_tree(struct _Blake3_job* const _Job, const uint64_t _Size,
+    const size_t _Threads, uint8_t* const _Out) {
+    const uint64_t _Count = (_Size - 1) / _BLAKE3_SUBTREE_SIZE; // the last subtree may be partial, see below
+    if (_Count > (uint64_t) MAXLONG || _Count > SIZE_MAX / BLAKE3_OUT_LEN) { // too many subtrees
+        return scfg_error_not_enough_memory;
+    }
+
+    _Job->_Count = (size_t) _Count;
+    _Job->_Next  = 0;
+    _Job->_Err   = scfg_error_success;
+    _Job->_Cvs   = (uint8_t*) malloc(_Job->_Count * BLAKE3_OUT_LEN);
+    if (!_Job->_Cvs) {
+        return scfg_error_not_enough_memory;
+    }
+
+    _Run_on_threads(_Run_blake3_job, _Job, _SCFG_MIN(_Threads, _Job->_Count));
+    if (_Job->_Err != scfg_error_success) {
+        free(_Job->_Cvs);
+        return (scfg_error_t) _Job->_Err;
+    }
+
+    // merge the full subtrees the same way as chunks, a pair is merged once its parent is complete
+    const blake3_hasher* const _Base = _Job->_Base;
+    uint8_t _Stack[(BLAKE3_MAX_DEPTH + 1) * BLAKE3_OUT_LEN];
+    size_t _Stack_size = 0;
+    struct _Blake3_output _Output;
+    for (size_t _Idx = 0; _Idx < _Job->_Count; ++_Idx) {
+        memcpy(_Stack + _Stack_size * BLAKE3_OUT_LEN, _Job->_Cvs + _Idx * BLAKE3_OUT_LEN, BLAKE3_OUT_LEN);
+        ++_Stack_size;
+        for (size_t _Total = _Idx + 1; (_Total & 1) == 0; _Total >>= 1) {
+            uint8_t* const _Left_cv = _Stack + (_Stack_size - 2) * BLAKE3_OUT_LEN;
+            _Get_parent_block_output(_Base, _Left_cv, &_Output); // both children are adjacent
+            _Get_chaining_value(&_Output, _Left_cv);
+            --_Stack_size;
+        }
+    }
+
+    free(_Job->_Cvs);
+    const uint64_t _Last_off   = _Count * _BLAKE3_SUBTREE_SIZE;
+    const size_t _Last_size    = (size_t) (_Size - _Last_off);
+    const uint64_t _Last_chunk = _Count * _BLAKE3_SUBTREE_CHUNKS;
+    if (_Job->_File) {
+        uint8_t* const _Buf = (uint8_t*) malloc(_Last_size);
+        if (!_Buf) {
+            return scfg_error_not_enough_memory;
+        }
+
+        const scfg_error_t _Err = _Read_subtree(_Job->_File, _Last_off, _Last_size, _Buf);
+        if (_Err != scfg_error_success) {
+            free(_Buf);
+            return _Err;
+        }
+
+        _Hash_subtree(_Base, _Buf, _Last_size, _Last_chunk, &_Output);
+        free(_Buf);
+    } else {
+        _Hash_subtree(_Base, _Job->_Data + (size_t) _Last_off, _Last_size, _Last_chunk, &_Output);
+    }
+
+    for (; _Stack_size > 0; --_Stack_size) {
+        _Get_parent_output(_Base, _Stack + (_Stack_size - 1) * BLAKE3_OUT_LEN, &_Output, &_Output);
+    }
+
+    uint32_t _Words[8];
+    _Blake3_compress(&_Output, _BLAKE3_ROOT, _Words);
+    _Store_words(_Words, _Out);
+    return scfg_error_success;
+}
+
+scfg_error_t _SCFG_CONV _Hash_blake3_parallel(const blake3_hasher* const _Base, const uint8_t* const _Data,
+    const size_t _Size, const size_t _Thread_count, uint8_t* const _Out) {
+    const size_t _Threads = _Get_thread_count(_Thread_count);
+    if (_Threads <= 1 || _Size <= _BLAKE3_SUBTREE_SIZE) { // not worth splitting
+        blake3_hasher _Hasher = *_Base;
+        blake3_hasher_update(&_Hasher, _Data, _Size);
+        blake3_hasher_finalize(&_Hasher, _Out, BLAKE3_OUT_LEN);
+        return scfg_error_success;
+    }
+
+    struct _Blake3_job _Job;
+    _Job._Base = _Base;
+    _Job._Data = _Data;
+    _Job._File = NULL;
+    return _Hash_blake3_tree(&_Job, _Size, _Threads, _Out);
+}
+
+scfg_error_t _SCFG_CONV _Hash_blake3_file_parallel(const blake3_hasher* const _Base, const HANDLE _File,
+    const uint64_t _Size, const size_t _Thread_count, uint8_t* const _Out) {
+    const size_t _Threads = _Get_thread_count(_Thread_count);
+    if (_Threads <= 1 || _Size <= _BLAKE3_SUBTREE_SIZE) { // not worth splitting, read it subtree by subtree
+        uint8_t* const _Buf = (uint8_t*) malloc((size_t) _SCFG_MIN(_Size, (uint64_t) _BLAKE3_SUBTREE_SIZE));
+        if (!_Buf && _Size > 0) {
+            return scfg_error_not_enough_memory;
+        }
+
+        blake3_hasher _Hasher = *_Base;
+        for (uint64_t _Off = 0; _Off < _Size; _Off += _BLAKE3_SUBTREE_SIZE) {
+            const size_t _Read_size = (size_t) _SCFG_MIN(_Size - _Off, (uint64_t) _BLAKE3_SUBTREE_SIZE);
+            const scfg_error_t _Err = _Read_subtree(_File, _Off, _Read_size, _Buf);
+            if (_Err != scfg_error_success) {
+                free(_Buf);
+                return _Err;
+            }
+
+            blake3_hasher_update(&_Hasher, _Buf, _Read_size);
+        }
+
+        free(_Buf);
+        blake3_hasher_finalize(&_Hasher, _Out, BLAKE3_OUT_LEN);
+        return scfg_error_success;
+    }
+
+    struct _Blake3_job _Job;
+    _Job._Base = _Base;
+    _Job._Data = NULL;
+    _Job._File = _File;
+    return _Hash_blake3_tree(&_Job, _Size, _Threads, _Out);
+}
+
+inline size_t _SCFG_CONV _Get_batch_group(const size_t _Size) {
+    // Note: Messages of a group have the same number of whole blocks before the last block, and their
+    //       last blocks are either all whole or all partial. An empty message has a partial last block.
+    if (_Size == 0) {
+        return 0;
+    }
+
+    return (_Size - 1) / BLAKE3_BLOCK_LEN * 2 + (_Size % BLAKE3_BLOCK_LEN == 0 ? 1 : 0);
+}
+
+inline void _SCFG_CONV _Hash_blake3_group(const uint8_t* const* const _Data, const size_t* const _Sizes,
+    const size_t* const _Idxs, const size_t _Count, const size_t _Group, uint8_t* const _Out) {
+    const uint8_t* _Inputs[_BLAKE3_BATCH_SIZE];
+    uint8_t _Cvs[_BLAKE3_BATCH_SIZE * BLAKE3_OUT_LEN];
+    for (size_t _Idx = 0; _Idx < _Count; ++_Idx) {
+        _Inputs[_Idx] = _Data[_Idxs[_Idx]];
+    }
+
+    const size_t _Whole = _Group / 2; // whole blocks before the last block
+    if (_Group & 1) { // the last block is whole as well, so every block is compressed by the library
+        blake3_hash_many(_Inputs, _Count, _Whole + 1, _Blake3_iv, 0, false, 0, _BLAKE3_CHUNK_START,
+            _BLAKE3_CHUNK_END | _BLAKE3_ROOT, _Cvs);
+        for (size_t _Idx = 0; _Idx < _Count; ++_Idx) {
+            memcpy(_Out + _Idxs[_Idx] * BLAKE3_OUT_LEN, _Cvs + _Idx * BLAKE3_OUT_LEN, BLAKE3_OUT_LEN);
+        }
+
+        return;
+    }
+
+    if (_Whole > 0) {
+        blake3_hash_many(_Inputs, _Count, _Whole, _Blake3_iv, 0, false, 0, _BLAKE3_CHUNK_START, 0, _Cvs);
+    }
+
+    struct _Blake3_output _Output;
+    uint32_t _Words[8];
+    for (size_t _Idx = 0; _Idx < _Count; ++_Idx) { // the partial last block of each message
+        const size_t _Last_size = _Sizes[_Idxs[_Idx]] - _Whole * BLAKE3_BLOCK_LEN;
+        for (size_t _Word = 0; _Word < 8; ++_Word) {
+            _Output._Cv[_Word] =
+                _Whole > 0 ? _Load_word(_Cvs + _Idx * BLAKE3_OUT_LEN + _Word * 4) : _Blake3_iv[_Word];
+        }
+
+        memset(_Output._Block, 0, BLAKE3_BLOCK_LEN);
+        if (_Last_size > 0) { // an empty message may have no data
+            memcpy(_Output._Block, _Inputs[_Idx] + _Whole * BLAKE3_BLOCK_LEN, _Last_size);
+        }
+
+        _Output._Counter   = 0;
+        _Output._Block_len = (uint8_t) _Last_size;
+        _Output._Flags     = (uint8_t) (_BLAKE3_CHUNK_END | (_Whole == 0 ? _BLAKE3_CHUNK_START : 0));
+        _Blake3_compress(&_Output, _BLAKE3_ROOT, _Words);
+        _Store_words(_Words, _Out + _Idxs[_Idx] * BLAKE3_OUT_LEN);
+    }
+}
+
+void _SCFG_CONV _Hash_blake3_batch(
+    const uint8_t* const* const _Data, const size_t* const _Sizes, const size_t _Count, uint8_t* const _Out) {
+    uint32_t _Groups = 0; // one bit per group that has messages
+    for (size_t _Idx = 0; _Idx < _Count; ++_Idx) {
+        if (_Sizes[_Idx] <= BLAKE3_CHUNK_LEN) {
+            _Groups |= (uint32_t) 1 << _Get_batch_group(_Sizes[_Idx]);
+        }
+    }
+
+    size_t _Idxs[_BLAKE3_BATCH_SIZE]; // indices of the messages in the current batch
+    for (size_t _Group = 0; _Groups != 0; ++_Group, _Groups >>= 1) {
+        if ((_Groups & 1) == 0) { // no messages in this group
+            continue;
+        }
+
+        size_t _Batch = 0;
+        for (size_t _Idx = 0; _Idx < _Count; ++_Idx) {
+            if (_Sizes[_Idx] <= BLAKE3_CHUNK_LEN && _Get_batch_group(_Sizes[_Idx]) == _Group) {
+                _Idxs[_Batch++] = _Idx;
+                if (_Batch == _BLAKE3_BATCH_SIZE) {
+                    _Hash_blake3_group(_Data, _Sizes, _Idxs, _Batch, _Group, _Out);
+                    _Batch = 0;
+                }
+            }
+        }
+
+        if (_Batch > 0) {
+            _Hash_blake3_group(_Data, _Sizes, _Idxs, _Batch, _Group, _Out);
+        }
+    }
+}
\ No newline at end of file
@@ -4,6 +4,7 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include <inc/scfg.h>
+#include <mapping.h>
 #include <scfgpch.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -11,30 +12,95 @@
 #include <string.h>
 #include <wchar.h>
 
+#define _SMALL_UNICODE_BUFFER_SIZE (_SCFG_SMALL_BUFFER_SIZE / sizeof(wchar_t))
+#define _MAX_BYTE_BUFFER_SIZE      SIZE_MAX
+#define _MAX_UNICODE_BUFFER_SIZE   (SIZE_MAX / sizeof(wchar_t))
+
+inline __bool_t _SCFG_CONV _Is_valid_allocator(const scfg_allocator_t* const _Al) {
+    if (!_Al) { // a default allocator is always valid
+        return 1;
+    }
+
+    return _Al->version == _SCFG_ALLOCATOR_VERSION && _Al->allocate && _Al->deallocate;
+}
+
+inline void* _SCFG_CONV _Allocate_block(const size_t _Size, const scfg_allocator_t* const _Al) {
+    return _Al ? _Al->allocate(_Al->context, _Size, _SCFG_DEFAULT_ALIGNMENT) : malloc(_Size);
+}
+
+inline void _SCFG_CONV _Deallocate_block(
+    void* const _Ptr, const size_t _Size, const scfg_allocator_t* const _Al) {
+    if (_Al) { // use a custom allocator
+        _Al->deallocate(_Al->context, _Ptr, _Size);
+    } else { // use a default allocator
+        free(_Ptr);
+    }
+}
+
+inline void* _SCFG_CONV _Reallocate_block(void* const _Ptr, const size_t _Old_size, const size_t _Used_size,
+    const size_t _New_size, const scfg_allocator_t* const _Al) {
+    if (!_Al) { // use a default allocator, may grow the block in-place
+        return realloc(_Ptr, _New_size);
+    }
+
+    if (_Al->reallocate) { // use a custom reallocation
+        return _Al->reallocate(_Al->context, _Ptr, _Old_size, _New_size, _SCFG_DEFAULT_ALIGNMENT);
+    }
+
+    void* const _New_ptr = _Al->allocate(_Al->context, _New_size, _SCFG_DEFAULT_ALIGNMENT);
+    if (!_New_ptr) { // the old block is still valid
+        return NULL;
+    }
+
+    memcpy(_New_ptr, _Ptr, _SCFG_MIN(_Used_size, _New_size));
+    _Al->deallocate(_Al->context, _Ptr, _Old_size);
+    return _New_ptr;
+}
+
+inline size_t _SCFG_CONV _Calculate_growth(
+    const size_t _Old_capacity, const size_t _New_size, const size_t _Max_size) {
+    if (_Old_capacity > _Max_size - _Old_capacity / 2) { // geometric growth would overflow
+        return _Max_size;
+    }
+
+    // Note: Grow by 50%, so that a sequence of appends performs amortized O(1) copies.
+    return _SCFG_MAX(_Old_capacity + _Old_capacity / 2, _New_size);
+}
+
 inline scfg_error_t _SCFG_CONV _Init_byte_buffer(scfg_byte_buffer_t* const _Buf) {
     // Note: Use a small buffer by default.
-    _Buf->_Size = 0;
+    _Buf->_Size     = 0;
+    _Buf->_Capacity = _SCFG_SMALL_BUFFER_SIZE;
     memset(_Buf->_Small, 0, _SCFG_SMALL_BUFFER_SIZE);
     return scfg_error_success;
 }
 
 inline scfg_error_t _SCFG_CONV _Init_utf8_buffer(scfg_utf8_buffer_t* const _Buf) {
     // Note: Use a small buffer by default.
-    _Buf->_Size = 0;
+    _Buf->_Size     = 0;
+    _Buf->_Capacity = _SCFG_SMALL_BUFFER_SIZE;
     memset(_Buf->_Small, 0, _SCFG_SMALL_BUFFER_SIZE);
     return scfg_error_success;
 }
 
 inline scfg_error_t _SCFG_CONV _Init_unicode_buffer(scfg_unicode_buffer_t* const _Buf) {
     // Note: Use a small buffer by default.
+    _Buf->_Size     = 0;
+    _Buf->_Capacity = _SMALL_UNICODE_BUFFER_SIZE;
+    wmemset(_Buf->_Small, 0, _SMALL_UNICODE_BUFFER_SIZE);
+    return scfg_error_success;
+}
+
+inline scfg_error_t _SCFG_CONV _Init_mapped_buffer(scfg_mapped_buffer_t* const _Buf) {
+    // Note: Nothing is mapped until scfg_map_file() is called.
+    _Buf->_Ptr  = NULL;
     _Buf->_Size = 0;
-    wmemset(_Buf->_Small, 0, _SCFG_SMALL_BUFFER_SIZE / sizeof(wchar_t));
     return scfg_error_success;
 }
 
 inline scfg_error_t _SCFG_CONV _Get_associated_byte_buffer(
     scfg_byte_buffer_t* const _Buf, uint8_t** const _Ptr) {
-    if (_Buf->_Size <= _SCFG_SMALL_BUFFER_SIZE) { // use a small buffer
+    if (_Buf->_Capacity <= _SCFG_SMALL_BUFFER_SIZE) { // use a small buffer
         *_Ptr = _Buf->_Small;
     } else { // use a large buffer
         *_Ptr = _Buf->_Large;
@@ -45,7 +111,7 @@ inline scfg_error_t _SCFG_CONV _Get_associated_byte_buffer(
 
 inline scfg_error_t _SCFG_CONV _Get_associated_utf8_buffer(
     scfg_utf8_buffer_t* const _Buf, char** const _Ptr) {
-    if (_Buf->_Size <= _SCFG_SMALL_BUFFER_SIZE) { // use a small buffer
+    if (_Buf->_Capacity <= _SCFG_SMALL_BUFFER_SIZE) { // use a small buffer
         *_Ptr = _Buf->_Small;
     } else { // use a large buffer
         *_Ptr = _Buf->_Large;
@@ -56,7 +122,7 @@ inline scfg_error_t _SCFG_CONV _Get_associated_utf8_buffer(
 
 inline scfg_error_t _SCFG_CONV _Get_associated_unicode_buffer(
     scfg_unicode_buffer_t* const _Buf, wchar_t** const _Ptr) {
-    if (_Buf->_Size <= _SCFG_SMALL_BUFFER_SIZE / sizeof(wchar_t)) { // use a small buffer
+    if (_Buf->_Capacity <= _SMALL_UNICODE_BUFFER_SIZE) { // use a small buffer
         *_Ptr = _Buf->_Small;
     } else { // use a large buffer
         *_Ptr = _Buf->_Large;
@@ -65,341 +131,537 @@ inline scfg_error_t _SCFG_CONV _Get_associated_unicode_buffer(
     return scfg_error_success;
 }
 
+inline scfg_error_t _SCFG_CONV _Get_associated_mapped_buffer(
+    scfg_mapped_buffer_t* const _Buf, const uint8_t** const _Ptr) {
+    *_Ptr = _Buf->_Ptr;
+    return scfg_error_success;
+}
+
+inline scfg_error_t _SCFG_CONV _Get_byte_buffer_view(
+    scfg_byte_buffer_t* const _Buf, scfg_byte_view_t* const _View) {
+    uint8_t* _Ptr;
+    _Get_associated_byte_buffer(_Buf, &_Ptr);
+    _View->data = _Ptr;
+    _View->size = _Buf->_Size;
+    return scfg_error_success;
+}
+
+inline scfg_error_t _SCFG_CONV _Get_utf8_buffer_view(
+    scfg_utf8_buffer_t* const _Buf, scfg_utf8_view_t* const _View) {
+    char* _Ptr;
+    _Get_associated_utf8_buffer(_Buf, &_Ptr);
+    _View->data = _Ptr;
+    _View->size = _Buf->_Size;
+    return scfg_error_success;
+}
+
+inline scfg_error_t _SCFG_CONV _Get_unicode_buffer_view(
+    scfg_unicode_buffer_t* const _Buf, scfg_unicode_view_t* const _View) {
+    wchar_t* _Ptr;
+    _Get_associated_unicode_buffer(_Buf, &_Ptr);
+    _View->data = _Ptr;
+    _View->size = _Buf->_Size;
+    return scfg_error_success;
+}
+
+inline scfg_error_t _SCFG_CONV _Get_mapped_buffer_view(
+    scfg_mapped_buffer_t* const _Buf, scfg_byte_view_t* const _View) {
+    _View->data = _Buf->_Ptr;
+    _View->size = _Buf->_Size;
+    return scfg_error_success;
+}
+
 inline scfg_error_t _SCFG_CONV _Release_byte_buffer(
     scfg_byte_buffer_t* const _Buf, const scfg_allocator_t* const _Al) {
-    if (_Buf->_Size <= _SCFG_SMALL_BUFFER_SIZE) { // release a small buffer
-        memset(_Buf->_Small, 0, _SCFG_SMALL_BUFFER_SIZE);
-    } else { // release a large buffer
-        if (_Al) { // use a custom allocator
-            _Al->deallocate(_Buf->_Large);
-        } else { // use a default allocator
-            free(_Buf->_Large);
-        }
-
-        _Buf->_Large = NULL;
-        _Buf->_Size  = 0;
+    if (_Buf->_Capacity > _SCFG_SMALL_BUFFER_SIZE) { // release a large buffer
+        _Deallocate_block(_Buf->_Large, _Buf->_Capacity, _Al);
+        _Buf->_Capacity = _SCFG_SMALL_BUFFER_SIZE;
     }
 
+    memset(_Buf->_Small, 0, _SCFG_SMALL_BUFFER_SIZE); // also clears the old pointer
+    _Buf->_Size = 0;
     return scfg_error_success;
 }
 
 inline scfg_error_t _SCFG_CONV _Release_utf8_buffer(
     scfg_utf8_buffer_t* const _Buf, const scfg_allocator_t* const _Al) {
-    if (_Buf->_Size <= _SCFG_SMALL_BUFFER_SIZE) { // release a small buffer
-        memset(_Buf->_Small, 0, _SCFG_SMALL_BUFFER_SIZE);
-    } else { // release a large buffer
-        if (_Al) { // use a custom allocator
-            _Al->deallocate(_Buf->_Large);
-        } else { // use a default allocator
-            free(_Buf->_Large);
-        }
-
-        _Buf->_Large = NULL;
-        _Buf->_Size  = 0;
+    if (_Buf->_Capacity > _SCFG_SMALL_BUFFER_SIZE) { // release a large buffer
+        _Deallocate_block(_Buf->_Large, _Buf->_Capacity, _Al);
+        _Buf->_Capacity = _SCFG_SMALL_BUFFER_SIZE;
     }
 
+    memset(_Buf->_Small, 0, _SCFG_SMALL_BUFFER_SIZE); // also clears the old pointer
+    _Buf->_Size = 0;
     return scfg_error_success;
 }
 
 inline scfg_error_t _SCFG_CONV _Release_unicode_buffer(
     scfg_unicode_buffer_t* const _Buf, const scfg_allocator_t* const _Al) {
-    if (_Buf->_Size <= _SCFG_SMALL_BUFFER_SIZE / sizeof(wchar_t)) { // release a small buffer
-        wmemset(_Buf->_Small, 0, _SCFG_SMALL_BUFFER_SIZE / sizeof(wchar_t));
-    } else { // release a large buffer
-        if (_Al) { // use a custom allocator
-            _Al->deallocate(_Buf->_Large);
-        } else { // use a default allocator
-            free(_Buf->_Large);
-        }
-
-        _Buf->_Large = NULL;
-        _Buf->_Size  = 0;
+    if (_Buf->_Capacity > _SMALL_UNICODE_BUFFER_SIZE) { // release a large buffer
+        _Deallocate_block(_Buf->_Large, _Buf->_Capacity * sizeof(wchar_t), _Al);
+        _Buf->_Capacity = _SMALL_UNICODE_BUFFER_SIZE;
     }
 
+    wmemset(_Buf->_Small, 0, _SMALL_UNICODE_BUFFER_SIZE); // also clears the old pointer
+    _Buf->_Size = 0;
     return scfg_error_success;
 }
 
-inline scfg_error_t _SCFG_CONV _Resize_byte_buffer_using_sbo(
-    scfg_byte_buffer_t* const _Buf, const size_t _New_size, const scfg_allocator_t* const _Al) {
-    if (_New_size <= _SCFG_SMALL_BUFFER_SIZE) { // SBO is still available
-        if (_New_size < _Buf->_Size) { // decrease the buffer, fill the rest of the buffer with zeros
-            memset(_Buf->_Small + _New_size, 0, _SCFG_SMALL_BUFFER_SIZE - _New_size);
-        }
-
-        _Buf->_Size = _New_size;
-    } else { // SBO is no longer available
-        uint8_t* const _New_ptr = _Al ? (uint8_t*) _Al->allocate(_New_size) : (uint8_t*) malloc(_New_size);
+inline scfg_error_t _SCFG_CONV _Reallocate_byte_buffer(
+    scfg_byte_buffer_t* const _Buf, const size_t _New_capacity, const scfg_allocator_t* const _Al) {
+    // Note: _New_capacity must be greater than _SCFG_SMALL_BUFFER_SIZE and not less than _Buf->_Size.
+    uint8_t* _New_ptr;
+    if (_Buf->_Capacity <= _SCFG_SMALL_BUFFER_SIZE) { // move data from a small buffer
+        _New_ptr = (uint8_t*) _Allocate_block(_New_capacity, _Al);
         if (!_New_ptr) {
             return scfg_error_not_enough_memory;
         }
 
-        _Buf->_Size = _New_size;
-#pragma warning(suppress : 6385) // C6385: Reading invalid data
-        memcpy(_New_ptr, _Buf->_Small, _New_size);
-        memset(_Buf->_Small, 0, _SCFG_SMALL_BUFFER_SIZE);
-        _Buf->_Large = _New_ptr; // assign a new buffer
+        memcpy(_New_ptr, _Buf->_Small, _Buf->_Size);
+    } else { // resize a large buffer, try to avoid copying
+        _New_ptr = (uint8_t*) _Reallocate_block(
+            _Buf->_Large, _Buf->_Capacity, _Buf->_Size, _New_capacity, _Al);
+        if (!_New_ptr) { // the old buffer is still valid
+            return scfg_error_not_enough_memory;
+        }
     }
 
+    _Buf->_Large    = _New_ptr; // assign a new buffer
+    _Buf->_Capacity = _New_capacity;
     return scfg_error_success;
 }
 
-inline scfg_error_t _SCFG_CONV _Resize_utf8_buffer_using_sbo(
-    scfg_utf8_buffer_t* const _Buf, const size_t _New_size, const scfg_allocator_t* const _Al) {
-    if (_New_size <= _SCFG_SMALL_BUFFER_SIZE) { // SBO is still available
-        if (_New_size < _Buf->_Size) { // decrease the buffer, fill the rest of the buffer with zeros
-            memset(_Buf->_Small + _New_size, 0, _SCFG_SMALL_BUFFER_SIZE - _New_size);
-        }
-
-        _Buf->_Size = _New_size;
-    } else { // SBO is no longer available
-        char* const _New_ptr = _Al ? (char*) _Al->allocate(_New_size) : (char*) malloc(_New_size);
+inline scfg_error_t _SCFG_CONV _Reallocate_utf8_buffer(
+    scfg_utf8_buffer_t* const _Buf, const size_t _New_capacity, const scfg_allocator_t* const _Al) {
+    // Note: _New_capacity must be greater than _SCFG_SMALL_BUFFER_SIZE and not less than _Buf->_Size.
+    char* _New_ptr;
+    if (_Buf->_Capacity <= _SCFG_SMALL_BUFFER_SIZE) { // move data from a small buffer
+        _New_ptr = (char*) _Allocate_block(_New_capacity, _Al);
         if (!_New_ptr) {
             return scfg_error_not_enough_memory;
         }
 
-        _Buf->_Size = _New_size;
-#pragma warning(suppress : 6385) // C6385: Reading invalid data
-        memcpy(_New_ptr, _Buf->_Small, _New_size);
-        memset(_Buf->_Small, 0, _SCFG_SMALL_BUFFER_SIZE);
-        _Buf->_Large = _New_ptr; // assign a new buffer
+        memcpy(_New_ptr, _Buf->_Small, _Buf->_Size);
+    } else { // resize a large buffer, try to avoid copying
+        _New_ptr = (char*) _Reallocate_block(
+            _Buf->_Large, _Buf->_Capacity, _Buf->_Size, _New_capacity, _Al);
+        if (!_New_ptr) { // the old buffer is still valid
+            return scfg_error_not_enough_memory;
+        }
     }
 
+    _Buf->_Large    = _New_ptr; // assign a new buffer
+    _Buf->_Capacity = _New_capacity;
     return scfg_error_success;
 }
 
-inline scfg_error_t _SCFG_CONV _Resize_unicode_buffer_using_sbo(
-    scfg_unicode_buffer_t* const _Buf, const size_t _New_size, const scfg_allocator_t* const _Al) {
-    if (_New_size <= _SCFG_SMALL_BUFFER_SIZE / sizeof(wchar_t)) { // SBO is still available
-        if (_New_size < _Buf->_Size) { // decrease the buffer, fill the rest of the buffer with zeros
-            wmemset(_Buf->_Small + _New_size, 0, (_SCFG_SMALL_BUFFER_SIZE / sizeof(wchar_t)) - _New_size);
-        }
-
-        _Buf->_Size = _New_size;
-    } else { // SBO is no longer available
-        wchar_t* const _New_ptr = _Al ? (wchar_t*) _Al->allocate(_New_size * sizeof(wchar_t))
-            : (wchar_t*) malloc(_New_size * sizeof(wchar_t));
+inline scfg_error_t _SCFG_CONV _Reallocate_unicode_buffer(
+    scfg_unicode_buffer_t* const _Buf, const size_t _New_capacity, const scfg_allocator_t* const _Al) {
+    // Note: _New_capacity must be greater than _SMALL_UNICODE_BUFFER_SIZE and not less than _Buf->_Size.
+    wchar_t* _New_ptr;
+    if (_Buf->_Capacity <= _SMALL_UNICODE_BUFFER_SIZE) { // move data from a small buffer
+        _New_ptr = (wchar_t*) _Allocate_block(_New_capacity * sizeof(wchar_t), _Al);
         if (!_New_ptr) {
             return scfg_error_not_enough_memory;
         }
 
-        _Buf->_Size = _New_size;
-#pragma warning(suppress : 6385) // C6385: Reading invalid data
-        wmemcpy(_New_ptr, _Buf->_Small, _New_size);
-        wmemset(_Buf->_Small, 0, _SCFG_SMALL_BUFFER_SIZE / sizeof(wchar_t));
-        _Buf->_Large = _New_ptr; // assign a new buffer
+        wmemcpy(_New_ptr, _Buf->_Small, _Buf->_Size);
+    } else { // resize a large buffer, try to avoid copying
+        _New_ptr = (wchar_t*) _Reallocate_block(_Buf->_Large, _Buf->_Capacity * sizeof(wchar_t),
+            _Buf->_Size * sizeof(wchar_t), _New_capacity * sizeof(wchar_t), _Al);
+        if (!_New_ptr) { // the old buffer is still valid
+            return scfg_error_not_enough_memory;
+        }
     }
 
+    _Buf->_Large    = _New_ptr; // assign a new buffer
+    _Buf->_Capacity = _New_capacity;
     return scfg_error_success;
 }
 
-inline scfg_error_t _SCFG_CONV _Resize_byte_buffer_not_using_sbo(
+inline scfg_error_t _SCFG_CONV _Shrink_byte_buffer_to_sbo(
     scfg_byte_buffer_t* const _Buf, const size_t _New_size, const scfg_allocator_t* const _Al) {
-    if (_New_size > _SCFG_SMALL_BUFFER_SIZE) { // SBO is still not available
-        uint8_t* const _New_ptr = _Al ? (uint8_t*) _Al->allocate(_New_size) : (uint8_t*) malloc(_New_size);
-        if (!_New_ptr) {
-            return scfg_error_not_enough_memory;
-        }
+    uint8_t _Temp_buf[_SCFG_SMALL_BUFFER_SIZE]; // intentionally uninitialized
+    memcpy(_Temp_buf, _Buf->_Large, _New_size);
+    _Deallocate_block(_Buf->_Large, _Buf->_Capacity, _Al);
+    memcpy(_Buf->_Small, _Temp_buf, _New_size);
+    memset(_Buf->_Small + _New_size, 0, _SCFG_SMALL_BUFFER_SIZE - _New_size);
+    _Buf->_Size     = _New_size;
+    _Buf->_Capacity = _SCFG_SMALL_BUFFER_SIZE;
+    return scfg_error_success;
+}
+
+inline scfg_error_t _SCFG_CONV _Shrink_utf8_buffer_to_sbo(
+    scfg_utf8_buffer_t* const _Buf, const size_t _New_size, const scfg_allocator_t* const _Al) {
+    char _Temp_buf[_SCFG_SMALL_BUFFER_SIZE]; // intentionally uninitialized
+    memcpy(_Temp_buf, _Buf->_Large, _New_size);
+    _Deallocate_block(_Buf->_Large, _Buf->_Capacity, _Al);
+    memcpy(_Buf->_Small, _Temp_buf, _New_size);
+    memset(_Buf->_Small + _New_size, 0, _SCFG_SMALL_BUFFER_SIZE - _New_size);
+    _Buf->_Size     = _New_size;
+    _Buf->_Capacity = _SCFG_SMALL_BUFFER_SIZE;
+    return scfg_error_success;
+}
+
+inline scfg_error_t _SCFG_CONV _Shrink_unicode_buffer_to_sbo(
+    scfg_unicode_buffer_t* const _Buf, const size_t _New_size, const scfg_allocator_t* const _Al) {
+    wchar_t _Temp_buf[_SMALL_UNICODE_BUFFER_SIZE]; // intentionally uninitialized
+    wmemcpy(_Temp_buf, _Buf->_Large, _New_size);
+    _Deallocate_block(_Buf->_Large, _Buf->_Capacity * sizeof(wchar_t), _Al);
+    wmemcpy(_Buf->_Small, _Temp_buf, _New_size);
+    wmemset(_Buf->_Small + _New_size, 0, _SMALL_UNICODE_BUFFER_SIZE - _New_size);
+    _Buf->_Size     = _New_size;
+    _Buf->_Capacity = _SMALL_UNICODE_BUFFER_SIZE;
+    return scfg_error_success;
+}
 
-        memcpy(_New_ptr, _Buf->_Large, _SCFG_MIN(_Buf->_Size, _New_size));
-        if (_New_size > _Buf->_Size) { // fill the rest of the buffer with zeros
-            memset(_New_ptr + _Buf->_Size, 0, _New_size - _Buf->_Size);
+inline scfg_error_t _SCFG_CONV _Shrink_byte_buffer_to_fit(
+    scfg_byte_buffer_t* const _Buf, const scfg_allocator_t* const _Al) {
+    if (_Buf->_Capacity <= _SCFG_SMALL_BUFFER_SIZE || _Buf->_Capacity == _Buf->_Size) { // nothing to release
+        return scfg_error_success;
+    }
+
+    if (_Buf->_Size <= _SCFG_SMALL_BUFFER_SIZE) { // SBO is now available
+        return _Shrink_byte_buffer_to_sbo(_Buf, _Buf->_Size, _Al);
+    }
+
+    return _Reallocate_byte_buffer(_Buf, _Buf->_Size, _Al);
+}
+
+inline scfg_error_t _SCFG_CONV _Shrink_utf8_buffer_to_fit(
+    scfg_utf8_buffer_t* const _Buf, const scfg_allocator_t* const _Al) {
+    if (_Buf->_Capacity <= _SCFG_SMALL_BUFFER_SIZE || _Buf->_Capacity == _Buf->_Size) { // nothing to release
+        return scfg_error_success;
+    }
+
+    if (_Buf->_Size <= _SCFG_SMALL_BUFFER_SIZE) { // SBO is now available
+        return _Shrink_utf8_buffer_to_sbo(_Buf, _Buf->_Size, _Al);
+    }
+
+    return _Reallocate_utf8_buffer(_Buf, _Buf->_Size, _Al);
+}
+
+inline scfg_error_t _SCFG_CONV _Shrink_unicode_buffer_to_fit(
+    scfg_unicode_buffer_t* const _Buf, const scfg_allocator_t* const _Al) {
+    if (_Buf->_Capacity <= _SMALL_UNICODE_BUFFER_SIZE
+        || _Buf->_Capacity == _Buf->_Size) { // nothing to release
+        return scfg_error_success;
+    }
+
+    if (_Buf->_Size <= _SMALL_UNICODE_BUFFER_SIZE) { // SBO is now available
+        return _Shrink_unicode_buffer_to_sbo(_Buf, _Buf->_Size, _Al);
+    }
+
+    return _Reallocate_unicode_buffer(_Buf, _Buf->_Size, _Al);
+}
+
+inline scfg_error_t _SCFG_CONV _Reserve_byte_buffer(
+    scfg_byte_buffer_t* const _Buf, const size_t _New_capacity, const scfg_allocator_t* const _Al) {
+    if (_New_capacity <= _Buf->_Capacity) { // the buffer is already large enough
+        return scfg_error_success;
+    }
+
+    return _Reallocate_byte_buffer(_Buf, _New_capacity, _Al);
+}
+
+inline scfg_error_t _SCFG_CONV _Reserve_utf8_buffer(
+    scfg_utf8_buffer_t* const _Buf, const size_t _New_capacity, const scfg_allocator_t* const _Al) {
+    if (_New_capacity <= _Buf->_Capacity) { // the buffer is already large enough
+        return scfg_error_success;
+    }
+
+    return _Reallocate_utf8_buffer(_Buf, _New_capacity, _Al);
+}
+
+inline scfg_error_t _SCFG_CONV _Reserve_unicode_buffer(
+    scfg_unicode_buffer_t* const _Buf, const size_t _New_capacity, const scfg_allocator_t* const _Al) {
+    if (_New_capacity <= _Buf->_Capacity) { // the buffer is already large enough
+        return scfg_error_success;
+    }
+
+    if (_New_capacity > _MAX_UNICODE_BUFFER_SIZE) { // the size in bytes would overflow
+        return scfg_error_not_enough_memory;
+    }
+
+    return _Reallocate_unicode_buffer(_Buf, _New_capacity, _Al);
+}
+
+inline scfg_error_t _SCFG_CONV _Resize_byte_buffer(scfg_byte_buffer_t* const _Buf,
+    const size_t _New_size, const scfg_allocator_t* const _Al, const __bool_t _Zero_fill) {
+    if (_New_size == _Buf->_Size) { // nothing has changed
+        return scfg_error_success;
+    }
+
+    if (_New_size > _Buf->_Capacity) { // grow geometrically (may change the buffer location)
+        const scfg_error_t _Err = _Reallocate_byte_buffer(
+            _Buf, _Calculate_growth(_Buf->_Capacity, _New_size, _MAX_BYTE_BUFFER_SIZE), _Al);
+        if (_Err != scfg_error_success) {
+            return _Err;
         }
+    }
 
-        if (_Al) { // use a custom allocator
-            _Al->deallocate(_Buf->_Large);
-        } else { // use a default allocator
-            free(_Buf->_Large);
+    uint8_t* _Ptr;
+    _Get_associated_byte_buffer(_Buf, &_Ptr);
+    if (_New_size > _Buf->_Size) { // fill the rest of the buffer with zeros if requested
+        if (_Zero_fill) {
+            memset(_Ptr + _Buf->_Size, 0, _New_size - _Buf->_Size);
         }
+    } else if (_Buf->_Capacity <= _SCFG_SMALL_BUFFER_SIZE) { // keep unused small storage zeroed
+        memset(_Ptr + _New_size, 0, _Buf->_Size - _New_size);
+    }
+
+    _Buf->_Size = _New_size; // shrinking a large buffer keeps its capacity, even to 0
+    return scfg_error_success;
+}
+
+inline scfg_error_t _SCFG_CONV _Resize_utf8_buffer(scfg_utf8_buffer_t* const _Buf,
+    const size_t _New_size, const scfg_allocator_t* const _Al, const __bool_t _Zero_fill) {
+    if (_New_size == _Buf->_Size) { // nothing has changed
+        return scfg_error_success;
+    }
 
-        _Buf->_Large = _New_ptr; // assign a new buffer
-        _Buf->_Size  = _New_size;
-    } else { // SBI is now available
-        uint8_t _Temp_buf[_SCFG_SMALL_BUFFER_SIZE]; // intentionally uninitialized
-        const size_t _Min_size = _SCFG_MIN(_Buf->_Size, _New_size);
-        memcpy(_Temp_buf, _Buf->_Large, _Min_size);
-        if (_Al) { // use a custom allocator
-            _Al->deallocate(_Buf->_Large);
-        } else { // use a default allocator
-            free(_Buf->_Large);
+    if (_New_size > _Buf->_Capacity) { // grow geometrically (may change the buffer location)
+        const scfg_error_t _Err = _Reallocate_utf8_buffer(
+            _Buf, _Calculate_growth(_Buf->_Capacity, _New_size, _MAX_BYTE_BUFFER_SIZE), _Al);
+        if (_Err != scfg_error_success) {
+            return _Err;
         }
+    }
 
-        _Buf->_Large = NULL;
-        _Buf->_Size  = _New_size;
-        memcpy(_Buf->_Small, _Temp_buf, _Min_size);
+    char* _Ptr;
+    _Get_associated_utf8_buffer(_Buf, &_Ptr);
+    if (_New_size > _Buf->_Size) { // fill the rest of the buffer with zeros if requested
+        if (_Zero_fill) {
+            memset(_Ptr + _Buf->_Size, 0, _New_size - _Buf->_Size);
+        }
+    } else if (_Buf->_Capacity <= _SCFG_SMALL_BUFFER_SIZE) { // keep unused small storage zeroed
+        memset(_Ptr + _New_size, 0, _Buf->_Size - _New_size);
     }
 
+    _Buf->_Size = _New_size; // shrinking a large buffer keeps its capacity, even to 0
     return scfg_error_success;
 }
 
-inline scfg_error_t _SCFG_CONV _Resize_utf8_buffer_not_using_sbo(
-    scfg_utf8_buffer_t* const _Buf, const size_t _New_size, const scfg_allocator_t* const _Al) {
-    if (_New_size > _SCFG_SMALL_BUFFER_SIZE) { // SBO is still not available
-        char* const _New_ptr = _Al ? (char*) _Al->allocate(_New_size) : (char*) malloc(_New_size);
-        if (!_New_ptr) {
+inline scfg_error_t _SCFG_CONV _Resize_unicode_buffer(scfg_unicode_buffer_t* const _Buf,
+    const size_t _New_size, const scfg_allocator_t* const _Al, const __bool_t _Zero_fill) {
+    if (_New_size == _Buf->_Size) { // nothing has changed
+        return scfg_error_success;
+    }
+
+    if (_New_size > _Buf->_Capacity) { // grow geometrically (may change the buffer location)
+        if (_New_size > _MAX_UNICODE_BUFFER_SIZE) { // the size in bytes would overflow
             return scfg_error_not_enough_memory;
         }
 
-        memcpy(_New_ptr, _Buf->_Large, _SCFG_MIN(_Buf->_Size, _New_size));
-        if (_New_size > _Buf->_Size) { // fill the rest of the buffer with zeros
-            memset(_New_ptr + _Buf->_Size, 0, _New_size - _Buf->_Size);
+        const scfg_error_t _Err = _Reallocate_unicode_buffer(
+            _Buf, _Calculate_growth(_Buf->_Capacity, _New_size, _MAX_UNICODE_BUFFER_SIZE), _Al);
+        if (_Err != scfg_error_success) {
+            return _Err;
         }
+    }
 
-        if (_Al) { // use a custom allocator
-            _Al->deallocate(_Buf->_Large);
-        } else { // use a default allocator
-            free(_Buf->_Large);
+    wchar_t* _Ptr;
+    _Get_associated_unicode_buffer(_Buf, &_Ptr);
+    if (_New_size > _Buf->_Size) { // fill the rest of the buffer with zeros if requested
+        if (_Zero_fill) {
+            wmemset(_Ptr + _Buf->_Size, 0, _New_size - _Buf->_Size);
         }
+    } else if (_Buf->_Capacity <= _SMALL_UNICODE_BUFFER_SIZE) { // keep unused small storage zeroed
+        wmemset(_Ptr + _New_size, 0, _Buf->_Size - _New_size);
+    }
+
+    _Buf->_Size = _New_size; // shrinking a large buffer keeps its capacity, even to 0
+    return scfg_error_success;
+}
 
-        _Buf->_Large = _New_ptr; // assign a new buffer
-        _Buf->_Size  = _New_size;
-    } else { // SBI is now available
-        char _Temp_buf[_SCFG_SMALL_BUFFER_SIZE]; // intentionally uninitialized
-        const size_t _Min_size = _SCFG_MIN(_Buf->_Size, _New_size);
-        memcpy(_Temp_buf, _Buf->_Large, _Min_size);
-        if (_Al) { // use a custom allocator
-            _Al->deallocate(_Buf->_Large);
-        } else { // use a default allocator
-            free(_Buf->_Large);
+inline scfg_error_t _SCFG_CONV _Append_byte_buffer(scfg_byte_buffer_t* const _Buf,
+    const uint8_t* const _Data, const size_t _Size, const scfg_allocator_t* const _Al) {
+    if (_Size == 0) { // nothing to append
+        return scfg_error_success;
+    }
+
+    if (!_Data) {
+        return scfg_error_invalid_data;
+    }
+
+    if (_Size > _MAX_BYTE_BUFFER_SIZE - _Buf->_Size) { // the new size would overflow
+        return scfg_error_not_enough_memory;
+    }
+
+    const size_t _New_size = _Buf->_Size + _Size;
+    const uint8_t* _Src    = _Data;
+    uint8_t* _Ptr;
+    _Get_associated_byte_buffer(_Buf, &_Ptr);
+    if (_New_size > _Buf->_Capacity) { // grow geometrically (may change the buffer location)
+        const __bool_t _Aliased = _Src >= _Ptr && _Src < _Ptr + _Buf->_Size; // _Data points into the buffer
+        const size_t _Src_off   = _Aliased ? (size_t) (_Src - _Ptr) : 0;
+        const scfg_error_t _Err = _Reallocate_byte_buffer(
+            _Buf, _Calculate_growth(_Buf->_Capacity, _New_size, _MAX_BYTE_BUFFER_SIZE), _Al);
+        if (_Err != scfg_error_success) {
+            return _Err;
         }
 
-        _Buf->_Large = NULL;
-        _Buf->_Size  = _New_size;
-        memcpy(_Buf->_Small, _Temp_buf, _Min_size);
+        _Get_associated_byte_buffer(_Buf, &_Ptr);
+        if (_Aliased) { // the old buffer is no longer valid
+            _Src = _Ptr + _Src_off;
+        }
     }
 
+    memcpy(_Ptr + _Buf->_Size, _Src, _Size);
+    _Buf->_Size = _New_size;
     return scfg_error_success;
 }
 
-inline scfg_error_t _SCFG_CONV _Resize_unicode_buffer_not_using_sbo(
-    scfg_unicode_buffer_t* const _Buf, const size_t _New_size, const scfg_allocator_t* const _Al) {
-    if (_New_size > _SCFG_SMALL_BUFFER_SIZE / sizeof(wchar_t)) { // SBO is still not available
-        wchar_t* const _New_ptr = _Al ? (wchar_t*) _Al->allocate(_New_size * sizeof(wchar_t))
-            : (wchar_t*) malloc(_New_size * sizeof(wchar_t));
-        if (!_New_ptr) {
-            return scfg_error_not_enough_memory;
-        }
+inline scfg_error_t _SCFG_CONV _Append_utf8_buffer(scfg_utf8_buffer_t* const _Buf,
+    const char* const _Data, const size_t _Size, const scfg_allocator_t* const _Al) {
+    if (_Size == 0) { // nothing to append
+        return scfg_error_success;
+    }
 
-        wmemcpy(_New_ptr, _Buf->_Large, _SCFG_MIN(_Buf->_Size, _New_size));
-        if (_New_size > _Buf->_Size) { // fill the rest of the buffer with zeros
-            wmemset(_New_ptr + _Buf->_Size, 0, _New_size - _Buf->_Size);
-        }
+    if (!_Data) {
+        return scfg_error_invalid_data;
+    }
 
-        if (_Al) { // use a custom allocator
-            _Al->deallocate(_Buf->_Large);
-        } else { // use a default allocator
-            free(_Buf->_Large);
-        }
+    if (_Size > _MAX_BYTE_BUFFER_SIZE - _Buf->_Size) { // the new size would overflow
+        return scfg_error_not_enough_memory;
+    }
 
-        _Buf->_Large = _New_ptr; // assign a new buffer
-        _Buf->_Size  = _New_size;
-    } else { // SBI is now available
-        wchar_t _Temp_buf[_SCFG_SMALL_BUFFER_SIZE / sizeof(wchar_t)]; // intentionally uninitialized
-        const size_t _Min_size = _SCFG_MIN(_Buf->_Size, _New_size);
-        wmemcpy(_Temp_buf, _Buf->_Large, _Min_size);
-        if (_Al) { // use a custom allocator
-            _Al->deallocate(_Buf->_Large);
-        } else { // use a default allocator
-            free(_Buf->_Large);
+    const size_t _New_size = _Buf->_Size + _Size;
+    const char* _Src       = _Data;
+    char* _Ptr;
+    _Get_associated_utf8_buffer(_Buf, &_Ptr);
+    if (_New_size > _Buf->_Capacity) { // grow geometrically (may change the buffer location)
+        const __bool_t _Aliased = _Src >= _Ptr && _Src < _Ptr + _Buf->_Size; // _Data points into the buffer
+        const size_t _Src_off   = _Aliased ? (size_t) (_Src - _Ptr) : 0;
+        const scfg_error_t _Err = _Reallocate_utf8_buffer(
+            _Buf, _Calculate_growth(_Buf->_Capacity, _New_size, _MAX_BYTE_BUFFER_SIZE), _Al);
+        if (_Err != scfg_error_success) {
+            return _Err;
         }
 
-        _Buf->_Large = NULL;
-        _Buf->_Size  = _New_size;
-        wmemcpy(_Buf->_Small, _Temp_buf, _Min_size);
+        _Get_associated_utf8_buffer(_Buf, &_Ptr);
+        if (_Aliased) { // the old buffer is no longer valid
+            _Src = _Ptr + _Src_off;
+        }
     }
 
+    memcpy(_Ptr + _Buf->_Size, _Src, _Size);
+    _Buf->_Size = _New_size;
     return scfg_error_success;
 }
 
-inline scfg_error_t _SCFG_CONV _Resize_byte_buffer(scfg_byte_buffer_t* const _Buf,
-    const size_t _New_size, const scfg_allocator_t* const _Al) {
-    if (_New_size == _Buf->_Size) { // nothing has changed
+inline scfg_error_t _SCFG_CONV _Append_unicode_buffer(scfg_unicode_buffer_t* const _Buf,
+    const wchar_t* const _Data, const size_t _Size, const scfg_allocator_t* const _Al) {
+    if (_Size == 0) { // nothing to append
         return scfg_error_success;
-    } else if (_New_size == 0) { // release the buffer
-        return scfg_release_buffer(_Buf, scfg_buffer_type_byte, _Al);
-    } else if (_Buf->_Size == 0) { // allocate or initialize a new buffer
-        if (_New_size <= _SCFG_SMALL_BUFFER_SIZE) { // prepare a small buffer
-            _Buf->_Size = _New_size;
-            memset(_Buf->_Small, 0, _SCFG_SMALL_BUFFER_SIZE); // fill the buffer with zeros
-        } else { // prepare a larger buffer
-            _Buf->_Large = _Al ? (uint8_t*) _Al->allocate(_New_size) : (uint8_t*) malloc(_New_size);
-            if (!_Buf->_Large) {
-                return scfg_error_not_enough_memory;
-            }
-
-            _Buf->_Size = _New_size;
-            memset(_Buf->_Large, 0, _New_size); // fill the buffer with zeros
+    }
+
+    if (!_Data) {
+        return scfg_error_invalid_data;
+    }
+
+    if (_Size > _MAX_UNICODE_BUFFER_SIZE - _Buf->_Size) { // the new size would overflow
+        return scfg_error_not_enough_memory;
+    }
+
+    const size_t _New_size = _Buf->_Size + _Size;
+    const wchar_t* _Src    = _Data;
+    wchar_t* _Ptr;
+    _Get_associated_unicode_buffer(_Buf, &_Ptr);
+    if (_New_size > _Buf->_Capacity) { // grow geometrically (may change the buffer location)
+        const __bool_t _Aliased = _Src >= _Ptr && _Src < _Ptr + _Buf->_Size; // _Data points into the buffer
+        const size_t _Src_off   = _Aliased ? (size_t) (_Src - _Ptr) : 0;
+        const scfg_error_t _Err = _Reallocate_unicode_buffer(
+            _Buf, _Calculate_growth(_Buf->_Capacity, _New_size, _MAX_UNICODE_BUFFER_SIZE), _Al);
+        if (_Err != scfg_error_success) {
+            return _Err;
         }
 
-        return scfg_error_success;
-    } else { // increase or decrease an old buffer (may change the buffer location)
-        if (_Buf->_Size <= _SCFG_SMALL_BUFFER_SIZE) {
-            return _Resize_byte_buffer_using_sbo(_Buf, _New_size, _Al);
-        } else {
-            return _Resize_byte_buffer_not_using_sbo(_Buf, _New_size, _Al);
+        _Get_associated_unicode_buffer(_Buf, &_Ptr);
+        if (_Aliased) { // the old buffer is no longer valid
+            _Src = _Ptr + _Src_off;
         }
     }
+
+    wmemcpy(_Ptr + _Buf->_Size, _Src, _Size);
+    _Buf->_Size = _New_size;
+    return scfg_error_success;
 }
 
-inline scfg_error_t _SCFG_CONV _Resize_utf8_buffer(scfg_utf8_buffer_t* const _Buf,
-    const size_t _New_size, const scfg_allocator_t* const _Al) {
-    if (_New_size == _Buf->_Size) { // nothing has changed
+inline scfg_error_t _SCFG_CONV _Move_byte_buffer(
+    scfg_byte_buffer_t* const _Dest, scfg_byte_buffer_t* const _Src, const scfg_allocator_t* const _Al) {
+    if (_Dest == _Src) { // nothing to move
         return scfg_error_success;
-    } else if (_New_size == 0) { // release the buffer
-        return scfg_release_buffer(_Buf, scfg_buffer_type_utf8, _Al);
-    } else if (_Buf->_Size == 0) { // allocate or initialize a new buffer
-        if (_New_size <= _SCFG_SMALL_BUFFER_SIZE) { // prepare a small buffer
-            _Buf->_Size = _New_size;
-            memset(_Buf->_Small, 0, _SCFG_SMALL_BUFFER_SIZE); // fill the buffer with zeros
-        } else { // prepare a larger buffer
-            _Buf->_Large = _Al ? (char*) _Al->allocate(_New_size) : (char*) malloc(_New_size);
-            if (!_Buf->_Large) {
-                return scfg_error_not_enough_memory;
-            }
-
-            _Buf->_Size = _New_size;
-            memset(_Buf->_Large, 0, _New_size); // fill the buffer with zeros
-        }
+    }
 
+    _Release_byte_buffer(_Dest, _Al);
+    *_Dest = *_Src; // steal a large buffer or copy a small one
+    return _Init_byte_buffer(_Src);
+}
+
+inline scfg_error_t _SCFG_CONV _Move_utf8_buffer(
+    scfg_utf8_buffer_t* const _Dest, scfg_utf8_buffer_t* const _Src, const scfg_allocator_t* const _Al) {
+    if (_Dest == _Src) { // nothing to move
         return scfg_error_success;
-    } else { // increase or decrease an old buffer (may change the buffer location)
-        if (_Buf->_Size <= _SCFG_SMALL_BUFFER_SIZE) {
-            return _Resize_utf8_buffer_using_sbo(_Buf, _New_size, _Al);
-        } else {
-            return _Resize_utf8_buffer_not_using_sbo(_Buf, _New_size, _Al);
-        }
     }
+
+    _Release_utf8_buffer(_Dest, _Al);
+    *_Dest = *_Src; // steal a large buffer or copy a small one
+    return _Init_utf8_buffer(_Src);
 }
 
-inline scfg_error_t _SCFG_CONV _Resize_unicode_buffer(scfg_unicode_buffer_t* const _Buf,
-    const size_t _New_size, const scfg_allocator_t* const _Al) {
-    if (_New_size == _Buf->_Size) { // nothing has changed
+inline scfg_error_t _SCFG_CONV _Move_unicode_buffer(scfg_unicode_buffer_t* const _Dest,
+    scfg_unicode_buffer_t* const _Src, const scfg_allocator_t* const _Al) {
+    if (_Dest == _Src) { // nothing to move
         return scfg_error_success;
-    } else if (_New_size == 0) { // release the buffer
-        return scfg_release_buffer(_Buf, scfg_buffer_type_unicode, _Al);
-    } else if (_Buf->_Size == 0) { // allocate or initialize a new buffer
-        if (_New_size <= _SCFG_SMALL_BUFFER_SIZE / sizeof(wchar_t)) { // prepare a small buffer
-            _Buf->_Size = _New_size;
-            wmemset(
-                _Buf->_Small, 0, _SCFG_SMALL_BUFFER_SIZE / sizeof(wchar_t)); // fill the buffer with zeros
-        } else { // prepare a larger buffer
-            _Buf->_Large = _Al ? (wchar_t*) _Al->allocate(_New_size * sizeof(wchar_t))
-                : (wchar_t*) malloc(_New_size * sizeof(wchar_t));
-            if (!_Buf->_Large) {
-                return scfg_error_not_enough_memory;
-            }
-
-            _Buf->_Size = _New_size;
-            wmemset(_Buf->_Large, 0, _New_size); // fill the buffer with zeros
-        }
+    }
+
+    _Release_unicode_buffer(_Dest, _Al);
+    *_Dest = *_Src; // steal a large buffer or copy a small one
+    return _Init_unicode_buffer(_Src);
+}
 
+inline scfg_error_t _SCFG_CONV _Move_mapped_buffer(
+    scfg_mapped_buffer_t* const _Dest, scfg_mapped_buffer_t* const _Src) {
+    if (_Dest == _Src) { // nothing to move
         return scfg_error_success;
-    } else { // increase or decrease an old buffer (may change the buffer location)
-        if (_Buf->_Size <= _SCFG_SMALL_BUFFER_SIZE / sizeof(wchar_t)) {
-            return _Resize_unicode_buffer_using_sbo(_Buf, _New_size, _Al);
-        } else {
-            return _Resize_unicode_buffer_not_using_sbo(_Buf, _New_size, _Al);
-        }
     }
+
+    _Unmap_file(_Dest);
+    *_Dest = *_Src; // steal the view
+    return _Init_mapped_buffer(_Src);
+}
+
+inline scfg_error_t _SCFG_CONV _Swap_byte_buffer(
+    scfg_byte_buffer_t* const _Left, scfg_byte_buffer_t* const _Right) {
+    const scfg_byte_buffer_t _Temp = *_Left; // exchange large pointers or small buffers
+    *_Left  = *_Right;
+    *_Right = _Temp;
+    return scfg_error_success;
+}
+
+inline scfg_error_t _SCFG_CONV _Swap_utf8_buffer(
+    scfg_utf8_buffer_t* const _Left, scfg_utf8_buffer_t* const _Right) {
+    const scfg_utf8_buffer_t _Temp = *_Left; // exchange large pointers or small buffers
+    *_Left  = *_Right;
+    *_Right = _Temp;
+    return scfg_error_success;
+}
+
+inline scfg_error_t _SCFG_CONV _Swap_unicode_buffer(
+    scfg_unicode_buffer_t* const _Left, scfg_unicode_buffer_t* const _Right) {
+    const scfg_unicode_buffer_t _Temp = *_Left; // exchange large pointers or small buffers
+    *_Left  = *_Right;
+    *_Right = _Temp;
+    return scfg_error_success;
+}
+
+inline scfg_error_t _SCFG_CONV _Swap_mapped_buffer(
+    scfg_mapped_buffer_t* const _Left, scfg_mapped_buffer_t* const _Right) {
+    const scfg_mapped_buffer_t _Temp = *_Left; // exchange views
+    *_Left  = *_Right;
+    *_Right = _Temp;
+    return scfg_error_success;
 }
 
 scfg_error_t _SCFG_CONV scfg_initialize_buffer(void* const _Buf, const scfg_buffer_type_t _Type) {
@@ -414,6 +676,8 @@ scfg_error_t _SCFG_CONV scfg_initialize_buffer(void* const _Buf, const scfg_buff
         return _Init_utf8_buffer((scfg_utf8_buffer_t*) _Buf);
     case scfg_buffer_type_unicode:
         return _Init_unicode_buffer((scfg_unicode_buffer_t*) _Buf);
+    case scfg_buffer_type_mapped:
+        return _Init_mapped_buffer((scfg_mapped_buffer_t*) _Buf);
     default:
         return scfg_error_unknown_buffer_type;
     }
@@ -432,6 +696,56 @@ scfg_error_t _SCFG_CONV scfg_get_associated_buffer(
         return _Get_associated_utf8_buffer((scfg_utf8_buffer_t*) _Buf, (char**) _Ptr);
     case scfg_buffer_type_unicode:
         return _Get_associated_unicode_buffer((scfg_unicode_buffer_t*) _Buf, (wchar_t**) _Ptr);
+    case scfg_buffer_type_mapped:
+        return _Get_associated_mapped_buffer((scfg_mapped_buffer_t*) _Buf, (const uint8_t**) _Ptr);
+    default:
+        return scfg_error_unknown_buffer_type;
+    }
+}
+
+scfg_error_t _SCFG_CONV scfg_get_buffer_view(
+    void* const _Buf, const scfg_buffer_type_t _Type, void* const _View) {
+    if (!_Buf) {
+        return scfg_error_invalid_buffer;
+    }
+
+    if (!_View) {
+        return scfg_error_invalid_data;
+    }
+
+    switch (_Type) {
+    case scfg_buffer_type_byte:
+        return _Get_byte_buffer_view((scfg_byte_buffer_t*) _Buf, (scfg_byte_view_t*) _View);
+    case scfg_buffer_type_utf8:
+        return _Get_utf8_buffer_view((scfg_utf8_buffer_t*) _Buf, (scfg_utf8_view_t*) _View);
+    case scfg_buffer_type_unicode:
+        return _Get_unicode_buffer_view((scfg_unicode_buffer_t*) _Buf, (scfg_unicode_view_t*) _View);
+    case scfg_buffer_type_mapped:
+        return _Get_mapped_buffer_view((scfg_mapped_buffer_t*) _Buf, (scfg_byte_view_t*) _View);
+    default:
+        return scfg_error_unknown_buffer_type;
+    }
+}
+
+scfg_error_t _SCFG_CONV scfg_reserve_buffer(void* const _Buf, const scfg_buffer_type_t _Type,
+    const size_t _New_capacity, const scfg_allocator_t* const _Al) {
+    if (!_Buf) {
+        return scfg_error_invalid_buffer;
+    }
+
+    if (!_Is_valid_allocator(_Al)) {
+        return scfg_error_invalid_allocator;
+    }
+
+    switch (_Type) {
+    case scfg_buffer_type_byte:
+        return _Reserve_byte_buffer((scfg_byte_buffer_t*) _Buf, _New_capacity, _Al);
+    case scfg_buffer_type_utf8:
+        return _Reserve_utf8_buffer((scfg_utf8_buffer_t*) _Buf, _New_capacity, _Al);
+    case scfg_buffer_type_unicode:
+        return _Reserve_unicode_buffer((scfg_unicode_buffer_t*) _Buf, _New_capacity, _Al);
+    case scfg_buffer_type_mapped: // mapped files are read-only
+        return scfg_error_read_only_buffer;
     default:
         return scfg_error_unknown_buffer_type;
     }
@@ -443,13 +757,136 @@ scfg_error_t _SCFG_CONV scfg_resize_buffer(void* const _Buf, const scfg_buffer_t
         return scfg_error_invalid_buffer;
     }
 
+    if (!_Is_valid_allocator(_Al)) {
+        return scfg_error_invalid_allocator;
+    }
+
+    switch (_Type) {
+    case scfg_buffer_type_byte:
+        return _Resize_byte_buffer((scfg_byte_buffer_t*) _Buf, _New_size, _Al, 1);
+    case scfg_buffer_type_utf8:
+        return _Resize_utf8_buffer((scfg_utf8_buffer_t*) _Buf, _New_size, _Al, 1);
+    case scfg_buffer_type_unicode:
+        return _Resize_unicode_buffer((scfg_unicode_buffer_t*) _Buf, _New_size, _Al, 1);
+    case scfg_buffer_type_mapped: // mapped files are read-only
+        return scfg_error_read_only_buffer;
+    default:
+        return scfg_error_unknown_buffer_type;
+    }
+}
+
+scfg_error_t _SCFG_CONV scfg_resize_buffer_uninitialized(void* const _Buf, const scfg_buffer_type_t _Type,
+    const size_t _New_size, const scfg_allocator_t* const _Al) {
+    if (!_Buf) {
+        return scfg_error_invalid_buffer;
+    }
+
+    if (!_Is_valid_allocator(_Al)) {
+        return scfg_error_invalid_allocator;
+    }
+
+    // Note: The new elements are left uninitialized, the caller is expected to overwrite them.
+    switch (_Type) {
+    case scfg_buffer_type_byte:
+        return _Resize_byte_buffer((scfg_byte_buffer_t*) _Buf, _New_size, _Al, 0);
+    case scfg_buffer_type_utf8:
+        return _Resize_utf8_buffer((scfg_utf8_buffer_t*) _Buf, _New_size, _Al, 0);
+    case scfg_buffer_type_unicode:
+        return _Resize_unicode_buffer((scfg_unicode_buffer_t*) _Buf, _New_size, _Al, 0);
+    case scfg_buffer_type_mapped: // mapped files are read-only
+        return scfg_error_read_only_buffer;
+    default:
+        return scfg_error_unknown_buffer_type;
+    }
+}
+
+scfg_error_t _SCFG_CONV scfg_shrink_buffer(
+    void* const _Buf, const scfg_buffer_type_t _Type, const scfg_allocator_t* const _Al) {
+    if (!_Buf) {
+        return scfg_error_invalid_buffer;
+    }
+
+    if (!_Is_valid_allocator(_Al)) {
+        return scfg_error_invalid_allocator;
+    }
+
     switch (_Type) {
     case scfg_buffer_type_byte:
-        return _Resize_byte_buffer((scfg_byte_buffer_t*) _Buf, _New_size, _Al);
+        return _Shrink_byte_buffer_to_fit((scfg_byte_buffer_t*) _Buf, _Al);
     case scfg_buffer_type_utf8:
-        return _Resize_utf8_buffer((scfg_utf8_buffer_t*) _Buf, _New_size, _Al);
+        return _Shrink_utf8_buffer_to_fit((scfg_utf8_buffer_t*) _Buf, _Al);
     case scfg_buffer_type_unicode:
-        return _Resize_unicode_buffer((scfg_unicode_buffer_t*) _Buf, _New_size, _Al);
+        return _Shrink_unicode_buffer_to_fit((scfg_unicode_buffer_t*) _Buf, _Al);
+    case scfg_buffer_type_mapped: // mapped files are read-only
+        return scfg_error_read_only_buffer;
+    default:
+        return scfg_error_unknown_buffer_type;
+    }
+}
+
+scfg_error_t _SCFG_CONV scfg_append_buffer(void* const _Buf, const scfg_buffer_type_t _Type,
+    const void* const _Data, const size_t _Size, const scfg_allocator_t* const _Al) {
+    if (!_Buf) {
+        return scfg_error_invalid_buffer;
+    }
+
+    if (!_Is_valid_allocator(_Al)) {
+        return scfg_error_invalid_allocator;
+    }
+
+    switch (_Type) {
+    case scfg_buffer_type_byte:
+        return _Append_byte_buffer((scfg_byte_buffer_t*) _Buf, (const uint8_t*) _Data, _Size, _Al);
+    case scfg_buffer_type_utf8:
+        return _Append_utf8_buffer((scfg_utf8_buffer_t*) _Buf, (const char*) _Data, _Size, _Al);
+    case scfg_buffer_type_unicode:
+        return _Append_unicode_buffer((scfg_unicode_buffer_t*) _Buf, (const wchar_t*) _Data, _Size, _Al);
+    case scfg_buffer_type_mapped: // mapped files are read-only
+        return scfg_error_read_only_buffer;
+    default:
+        return scfg_error_unknown_buffer_type;
+    }
+}
+
+scfg_error_t _SCFG_CONV scfg_move_buffer(void* const _Dest, void* const _Src,
+    const scfg_buffer_type_t _Type, const scfg_allocator_t* const _Al) {
+    if (!_Dest || !_Src) {
+        return scfg_error_invalid_buffer;
+    }
+
+    if (!_Is_valid_allocator(_Al)) {
+        return scfg_error_invalid_allocator;
+    }
+
+    switch (_Type) {
+    case scfg_buffer_type_byte:
+        return _Move_byte_buffer((scfg_byte_buffer_t*) _Dest, (scfg_byte_buffer_t*) _Src, _Al);
+    case scfg_buffer_type_utf8:
+        return _Move_utf8_buffer((scfg_utf8_buffer_t*) _Dest, (scfg_utf8_buffer_t*) _Src, _Al);
+    case scfg_buffer_type_unicode:
+        return _Move_unicode_buffer((scfg_unicode_buffer_t*) _Dest, (scfg_unicode_buffer_t*) _Src, _Al);
+    case scfg_buffer_type_mapped:
+        return _Move_mapped_buffer((scfg_mapped_buffer_t*) _Dest, (scfg_mapped_buffer_t*) _Src);
+    default:
+        return scfg_error_unknown_buffer_type;
+    }
+}
+
+scfg_error_t _SCFG_CONV scfg_swap_buffer(
+    void* const _Left, void* const _Right, const scfg_buffer_type_t _Type) {
+    if (!_Left || !_Right) {
+        return scfg_error_invalid_buffer;
+    }
+
+    switch (_Type) {
+    case scfg_buffer_type_byte:
+        return _Swap_byte_buffer((scfg_byte_buffer_t*) _Left, (scfg_byte_buffer_t*) _Right);
+    case scfg_buffer_type_utf8:
+        return _Swap_utf8_buffer((scfg_utf8_buffer_t*) _Left, (scfg_utf8_buffer_t*) _Right);
+    case scfg_buffer_type_unicode:
+        return _Swap_unicode_buffer((scfg_unicode_buffer_t*) _Left, (scfg_unicode_buffer_t*) _Right);
+    case scfg_buffer_type_mapped:
+        return _Swap_mapped_buffer((scfg_mapped_buffer_t*) _Left, (scfg_mapped_buffer_t*) _Right);
     default:
         return scfg_error_unknown_buffer_type;
     }
@@ -461,6 +898,10 @@ scfg_error_t _SCFG_CONV scfg_release_buffer(
         return scfg_error_invalid_buffer;
     }
 
+    if (!_Is_valid_allocator(_Al)) {
+        return scfg_error_invalid_allocator;
+    }
+
     switch (_Type) {
     case scfg_buffer_type_byte:
         return _Release_byte_buffer((scfg_byte_buffer_t*) _Buf, _Al);
@@ -468,6 +909,8 @@ scfg_error_t _SCFG_CONV scfg_release_buffer(
         return _Release_utf8_buffer((scfg_utf8_buffer_t*) _Buf, _Al);
     case scfg_buffer_type_unicode:
         return _Release_unicode_buffer((scfg_unicode_buffer_t*) _Buf, _Al);
+    case scfg_buffer_type_mapped:
+        return _Unmap_file((scfg_mapped_buffer_t*) _Buf);
     default:
         return scfg_error_unknown_buffer_type;
     }
@@ -0,0 +1,417 @@
+// cache.c
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <hash.h>
+#include <inc/scfg.h>
+#include <io.h>
+#include <scfgpch.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define _HASH_CACHE_MAGIC            0x43484353 // "SCHC"
+#define _HASH_CACHE_VERSION          1
+#define _DEFAULT_HASH_CACHE_CAPACITY 4096 // number of entries
+#define _MAX_HASH_CACHE_CAPACITY     16777216 // 2 GiB of entries
+#define _HASH_CACHE_PROBE_COUNT      4 // number of entries searched for a file
+#define _MAX_CACHED_HASH_SIZE        64
+#define _RACY_WRITE_TIME             20000000 // 2 seconds, in 100 ns units
+#define _HASH_CACHE_OPEN_LOCK        0x4000000000000000ULL // locked bytes lie past any entry
+#define _HASH_CACHE_USER_LOCK        (_HASH_CACHE_OPEN_LOCK + 1)
+
+// Note: The cache file is a header followed by a fixed number of entries. A writer makes the sequence
+//       number of an entry odd while it changes the entry, and readers ignore entries whose sequence
+//       number is odd or changes while they are read. This keeps updates atomic across processes.
+//       A writer that terminates while it changes an entry leaves the number of writers above zero,
+//       the entries are then recovered by the next process that opens the cache alone.
+struct _Hash_cache_header {
+    volatile LONG _Magic; // stored last, once the header is complete
+    uint32_t _Version;
+    uint32_t _Entry_size;
+    uint32_t _Capacity; // a power of two
+    volatile LONG _Writers; // number of entries being written
+    uint32_t _Reserved; // always 0, the entries are 8-byte aligned
+};
+
+struct _Hash_cache_key {
+    uint64_t _Volume;
+    uint8_t _File_id[16];
+    uint64_t _Off;
+    uint32_t _Id;
+    uint32_t _Reserved; // always 0, the key has no padding
+    uint64_t _Size; // the fields below tell whether a cached hash is still valid
+    uint64_t _Write_time; // 100 ns units since 1601
+};
+
+struct _Hash_cache_entry {
+    volatile LONG _Seq; // odd while the entry is being written
+    uint32_t _Used;
+    struct _Hash_cache_key _Key;
+    uint8_t _Hash[_MAX_CACHED_HASH_SIZE];
+};
+
+struct scfg_hash_cache {
+    HANDLE _File; // holds a shared lock while the cache is open
+    struct _Hash_cache_header* _Header; // the mapped view
+    struct _Hash_cache_entry* _Entries;
+    size_t _Mask; // capacity - 1
+    volatile LONG64 _Hits;
+    volatile LONG64 _Misses;
+};
+
+inline scfg_error_t _SCFG_CONV _Cleanup_cache_on_failure(
+    HANDLE _File, HANDLE _Mapping, void* const _View, const scfg_error_t _Err) {
+    if (_View) {
+        UnmapViewOfFile(_View);
+    }
+
+    if (_Mapping) {
+        CloseHandle(_Mapping);
+    }
+
+    CloseHandle(_File);
+    return _Err;
+}
+
+inline BOOL _SCFG_CONV _Lock_cache_byte(const HANDLE _File, const uint64_t _Off, const DWORD _Flags) {
+    OVERLAPPED _Overlapped = {0};
+    _Overlapped.Offset     = (DWORD) _Off;
+    _Overlapped.OffsetHigh = (DWORD) (_Off >> 32);
+    return LockFileEx(_File, _Flags, 0, 1, 0, &_Overlapped);
+}
+
+inline BOOL _SCFG_CONV _Unlock_cache_byte(const HANDLE _File, const uint64_t _Off) {
+    OVERLAPPED _Overlapped = {0};
+    _Overlapped.Offset     = (DWORD) _Off;
+    _Overlapped.OffsetHigh = (DWORD) (_Off >> 32);
+    return UnlockFileEx(_File, 0, 1, 0, &_Overlapped);
+}
+
+inline __bool_t _SCFG_CONV _Is_valid_cache_header(
+    const struct _Hash_cache_header* const _Header, const uint32_t _Capacity, const uint64_t _View_size) {
+    if (_Header->_Magic != _HASH_CACHE_MAGIC || _Header->_Version != _HASH_CACHE_VERSION
+        || _Header->_Entry_size != sizeof(struct _Hash_cache_entry)) {
+        return 0;
+    }
+
+    if (_Capacity == 0 || _Capacity > _MAX_HASH_CACHE_CAPACITY || (_Capacity & (_Capacity - 1)) != 0) {
+        return 0;
+    }
+
+    return _View_size
+        >= sizeof(struct _Hash_cache_header) + (uint64_t) _Capacity * sizeof(struct _Hash_cache_entry);
+}
+
+inline scfg_error_t _SCFG_CONV _Get_file_key(FILE* const _Stream, const size_t _Off,
+    const scfg_hash_id_t _Id, struct _Hash_cache_key* const _Key) {
+    if (fflush(_Stream) != 0) { // pending writes change the size and the write time
+        return scfg_error_invalid_stream;
+    }
+
+    const intptr_t _Os_handle = _get_osfhandle(_fileno(_Stream));
+    if (_Os_handle == -1) {
+        return scfg_error_invalid_stream;
+    }
+
+    // Note: The volume serial number and the 128-bit file ID identify a file on every file system.
+    const HANDLE _Handle = (HANDLE) _Os_handle;
+    FILE_ID_INFO _Id_info;
+    FILE_BASIC_INFO _Basic_info;
+    LARGE_INTEGER _File_size;
+    if (!GetFileInformationByHandleEx(_Handle, FileIdInfo, &_Id_info, sizeof(FILE_ID_INFO))
+        || !GetFileInformationByHandleEx(_Handle, FileBasicInfo, &_Basic_info, sizeof(FILE_BASIC_INFO))
+        || !GetFileSizeEx(_Handle, &_File_size)) {
+        return scfg_error_invalid_stream; // not a file on disk
+    }
+
+    memset(_Key, 0, sizeof(struct _Hash_cache_key));
+    memcpy(_Key->_File_id, &_Id_info.FileId, sizeof(_Key->_File_id));
+    _Key->_Volume     = (uint64_t) _Id_info.VolumeSerialNumber;
+    _Key->_Off        = (uint64_t) _Off;
+    _Key->_Id         = (uint32_t) _Id;
+    _Key->_Size       = (uint64_t) _File_size.QuadPart;
+    _Key->_Write_time = (uint64_t) _Basic_info.LastWriteTime.QuadPart;
+    return scfg_error_success;
+}
+
+inline __bool_t _SCFG_CONV _Is_racy_key(const struct _Hash_cache_key* const _Key) {
+    // Note: A file written within the last few seconds may be written again without changing
+    //       its write time, so its hash is not cached.
+    FILETIME _Time;
+    GetSystemTimeAsFileTime(&_Time);
+    const uint64_t _Now = ((uint64_t) _Time.dwHighDateTime << 32) | _Time.dwLowDateTime;
+    return _Key->_Write_time + _RACY_WRITE_TIME > _Now;
+}
+
+inline size_t _SCFG_CONV _Hash_cache_key(const struct _Hash_cache_key* const _Key) {
+    // Note: Only the file identity is hashed (FNV-1a), so a stale entry is found and replaced.
+    const uint8_t* const _Bytes = (const uint8_t*) _Key;
+    uint64_t _Hash              = 14695981039346656037ULL;
+    for (size_t _Idx = 0; _Idx < offsetof(struct _Hash_cache_key, _Size); ++_Idx) {
+        _Hash = (_Hash ^ _Bytes[_Idx]) * 1099511628211ULL;
+    }
+
+    return (size_t) (_Hash ^ (_Hash >> 32));
+}
+
+inline __bool_t _SCFG_CONV _Read_cache_entry(
+    const struct _Hash_cache_entry* const _Entry, struct _Hash_cache_entry* const _Copy) {
+    const LONG _Seq = _Entry->_Seq;
+    if ((_Seq & 1) != 0) { // being written
+        return 0;
+    }
+
+    MemoryBarrier();
+    memcpy(_Copy, (const void*) _Entry, sizeof(struct _Hash_cache_entry));
+    MemoryBarrier();
+    return _Entry->_Seq == _Seq;
+}
+
+inline void _SCFG_CONV _Write_cache_entry(struct _Hash_cache_header* const _Header,
+    struct _Hash_cache_entry* const _Entry, const struct _Hash_cache_key* const _Key,
+    const uint8_t* const _Hash, const size_t _Hash_size) {
+    const LONG _Seq = _Entry->_Seq;
+    if ((_Seq & 1) != 0) { // another writer owns the entry
+        return;
+    }
+
+    InterlockedIncrement(&_Header->_Writers); // counted before the entry can be left odd
+    if (InterlockedCompareExchange(&_Entry->_Seq, _Seq + 1, _Seq) == _Seq) {
+        _Entry->_Used = 1;
+        _Entry->_Key  = *_Key;
+        memcpy(_Entry->_Hash, _Hash, _Hash_size);
+        InterlockedExchange(&_Entry->_Seq, _Seq + 2); // publishes the entry
+    }
+
+    InterlockedDecrement(&_Header->_Writers);
+}
+
+inline void _SCFG_CONV _Recover_cache_entries(struct _Hash_cache_header* const _Header,
+    struct _Hash_cache_entry* const _Entries, const size_t _Capacity) {
+    // Note: No other process has the cache open, so an odd sequence number belongs to a writer that
+    //       terminated while it changed the entry. Such an entry may be incomplete and is released.
+    for (size_t _Idx = 0; _Idx < _Capacity; ++_Idx) {
+        if ((_Entries[_Idx]._Seq & 1) != 0) {
+            _Entries[_Idx]._Used = 0;
+            _Entries[_Idx]._Seq += 1;
+        }
+    }
+
+    _Header->_Writers = 0;
+}
+
+inline struct _Hash_cache_entry* _SCFG_CONV _Find_cache_entry(scfg_hash_cache_t* const _Cache,
+    const struct _Hash_cache_key* const _Key, uint8_t* const _Out, const size_t _Hash_size,
+    __bool_t* const _Hit) {
+    const size_t _Home                   = _Hash_cache_key(_Key) & _Cache->_Mask;
+    struct _Hash_cache_entry* _Free_slot = NULL;
+    struct _Hash_cache_entry _Copy;
+    *_Hit = 0;
+    for (size_t _Probe = 0; _Probe < _HASH_CACHE_PROBE_COUNT; ++_Probe) {
+        struct _Hash_cache_entry* const _Entry = &_Cache->_Entries[(_Home + _Probe) & _Cache->_Mask];
+        if (!_Read_cache_entry(_Entry, &_Copy)) {
+            continue;
+        }
+
+        if (!_Copy._Used) {
+            if (!_Free_slot) {
+                _Free_slot = _Entry;
+            }
+
+            continue;
+        }
+
+        if (memcmp(&_Copy._Key, _Key, offsetof(struct _Hash_cache_key, _Size)) == 0) { // the same file
+            if (memcmp(&_Copy._Key, _Key, sizeof(struct _Hash_cache_key)) == 0) {
+                memcpy(_Out, _Copy._Hash, _Hash_size);
+                *_Hit = 1;
+            }
+
+            return _Entry; // a stale entry is replaced
+        }
+    }
+
+    return _Free_slot ? _Free_slot : &_Cache->_Entries[_Home]; // evict the first entry if all are used
+}
+
+scfg_error_t _SCFG_CONV scfg_open_hash_cache(
+    const wchar_t* const _Path, const size_t _Capacity, scfg_hash_cache_t** const _Cache) {
+    if (!_Cache) {
+        return scfg_error_invalid_cache;
+    }
+
+    if (!_Path) {
+        return scfg_error_invalid_stream;
+    }
+
+    if (_Capacity > _MAX_HASH_CACHE_CAPACITY) {
+        return scfg_error_invalid_data;
+    }
+
+    size_t _Count = _Capacity != 0 ? 1 : _DEFAULT_HASH_CACHE_CAPACITY;
+    while (_Count < _Capacity) { // round up to a power of two
+        _Count <<= 1;
+    }
+
+    const HANDLE _File = CreateFileW(_Path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+        NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (_File == INVALID_HANDLE_VALUE) {
+        return scfg_error_invalid_stream;
+    }
+
+    // Note: The processes that open the cache are serialized by a lock, so a new cache is complete
+    //       before another process validates it. Every open cache holds a shared lock, the system
+    //       releases both locks when a process terminates. The locked bytes are never written.
+    if (!_Lock_cache_byte(_File, _HASH_CACHE_OPEN_LOCK, LOCKFILE_EXCLUSIVE_LOCK)) {
+        return _Cleanup_cache_on_failure(_File, NULL, NULL, scfg_error_invalid_stream);
+    }
+
+    const __bool_t _Only_user = (__bool_t) _Lock_cache_byte(
+        _File, _HASH_CACHE_USER_LOCK, LOCKFILE_EXCLUSIVE_LOCK | LOCKFILE_FAIL_IMMEDIATELY);
+    LARGE_INTEGER _File_size;
+    if (!GetFileSizeEx(_File, &_File_size)) {
+        return _Cleanup_cache_on_failure(_File, NULL, NULL, scfg_error_invalid_stream);
+    }
+
+    // Note: An empty file is a new cache. Mapping more than the size of the file extends it.
+    const __bool_t _Create = _File_size.QuadPart == 0;
+    if (_Create) {
+        _File_size.QuadPart =
+            (LONGLONG) (sizeof(struct _Hash_cache_header) + _Count * sizeof(struct _Hash_cache_entry));
+    } else if ((uint64_t) _File_size.QuadPart < sizeof(struct _Hash_cache_header)) {
+        return _Cleanup_cache_on_failure(_File, NULL, NULL, scfg_error_invalid_cache);
+    }
+
+    const HANDLE _Mapping = CreateFileMappingW(
+        _File, NULL, PAGE_READWRITE, (DWORD) (_File_size.QuadPart >> 32), (DWORD) _File_size.QuadPart, NULL);
+    if (!_Mapping) {
+        return _Cleanup_cache_on_failure(_File, NULL, NULL, scfg_error_invalid_stream);
+    }
+
+    struct _Hash_cache_header* const _Header =
+        (struct _Hash_cache_header*) MapViewOfFile(_Mapping, FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, 0);
+    if (!_Header) {
+        return _Cleanup_cache_on_failure(_File, _Mapping, NULL, scfg_error_invalid_stream);
+    }
+
+    // Note: The capacity is read once and checked against the size of this view, the entries
+    //       are never indexed through the shared header.
+    uint32_t _View_capacity;
+    if (_Create) { // the new file is filled with zeros, every entry is unused
+        _View_capacity       = (uint32_t) _Count;
+        _Header->_Version    = _HASH_CACHE_VERSION;
+        _Header->_Entry_size = (uint32_t) sizeof(struct _Hash_cache_entry);
+        _Header->_Capacity   = _View_capacity;
+        InterlockedExchange(&_Header->_Magic, _HASH_CACHE_MAGIC);
+    } else {
+        _View_capacity = _Header->_Capacity;
+        if (!_Is_valid_cache_header(_Header, _View_capacity, (uint64_t) _File_size.QuadPart)) {
+            return _Cleanup_cache_on_failure(_File, _Mapping, _Header, scfg_error_invalid_cache);
+        }
+    }
+
+    struct _Hash_cache_entry* const _Entries = (struct _Hash_cache_entry*) (_Header + 1);
+    if (_Only_user) {
+        if (_Header->_Writers != 0) {
+            _Recover_cache_entries(_Header, _Entries, _View_capacity);
+        }
+
+        _Unlock_cache_byte(_File, _HASH_CACHE_USER_LOCK);
+    }
+
+    if (!_Lock_cache_byte(_File, _HASH_CACHE_USER_LOCK, LOCKFILE_FAIL_IMMEDIATELY)) { // shared
+        return _Cleanup_cache_on_failure(_File, _Mapping, _Header, scfg_error_invalid_stream);
+    }
+
+    scfg_hash_cache_t* const _New_cache = (scfg_hash_cache_t*) malloc(sizeof(scfg_hash_cache_t));
+    if (!_New_cache) {
+        return _Cleanup_cache_on_failure(_File, _Mapping, _Header, scfg_error_not_enough_memory);
+    }
+
+    // Note: The view keeps the file mapping alive, its handle can be closed right away. The file
+    //       handle is kept to hold the shared lock.
+    _Unlock_cache_byte(_File, _HASH_CACHE_OPEN_LOCK);
+    CloseHandle(_Mapping);
+    _New_cache->_File    = _File;
+    _New_cache->_Header  = _Header;
+    _New_cache->_Entries = _Entries;
+    _New_cache->_Mask    = (size_t) _View_capacity - 1;
+    _New_cache->_Hits    = 0;
+    _New_cache->_Misses  = 0;
+    *_Cache              = _New_cache;
+    return scfg_error_success;
+}
+
+scfg_error_t _SCFG_CONV scfg_close_hash_cache(scfg_hash_cache_t* const _Cache) {
+    if (!_Cache) {
+        return scfg_error_invalid_cache;
+    }
+
+    FlushViewOfFile(_Cache->_Header, 0); // start writing the changed entries to the file
+    UnmapViewOfFile(_Cache->_Header);
+    CloseHandle(_Cache->_File); // releases the shared lock
+    free(_Cache);
+    return scfg_error_success;
+}
+
+scfg_error_t _SCFG_CONV scfg_hash_file_cached(scfg_hash_cache_t* const _Cache, FILE* const _Stream,
+    const size_t _Off, const scfg_hash_id_t _Id, const scfg_file_hash_options_t* const _Options,
+    scfg_byte_buffer_t* const _Buf) {
+    if (!_Cache) { // the cache is optional
+        return scfg_hash_file_with_options(_Stream, _Off, _Id, _Options, _Buf);
+    }
+
+    const size_t _Hash_size = _Get_hash_size(_Id);
+    if (_Hash_size == 0) {
+        return scfg_error_unsupported_hash;
+    }
+
+    if (!_Stream) {
+        return scfg_error_invalid_stream;
+    }
+
+    uint8_t* _Ptr;
+    scfg_error_t _Err = _Get_hash_buffer(_Buf, _Hash_size, &_Ptr);
+    if (_Err != scfg_error_success) {
+        return _Err;
+    }
+
+    struct _Hash_cache_key _Key;
+    struct _Hash_cache_entry* _Entry = NULL;
+    __bool_t _Hit                    = 0;
+    if (_Get_file_key(_Stream, _Off, _Id, &_Key) == scfg_error_success) { // pipes and consoles are not cached
+        _Entry = _Find_cache_entry(_Cache, &_Key, _Ptr, _Hash_size, &_Hit);
+    }
+
+    if (_Hit) {
+        InterlockedIncrement64(&_Cache->_Hits);
+        return scfg_error_success;
+    }
+
+    InterlockedIncrement64(&_Cache->_Misses);
+    _Err = scfg_hash_file_with_options(_Stream, _Off, _Id, _Options, _Buf);
+    if (_Err == scfg_error_success && _Entry && !_Is_racy_key(&_Key)) {
+        _Write_cache_entry(_Cache->_Header, _Entry, &_Key, _Ptr, _Hash_size);
+    }
+
+    return _Err;
+}
+
+scfg_error_t _SCFG_CONV scfg_get_hash_cache_stats(
+    scfg_hash_cache_t* const _Cache, scfg_hash_cache_stats_t* const _Stats) {
+    if (!_Cache) {
+        return scfg_error_invalid_cache;
+    }
+
+    if (!_Stats) {
+        return scfg_error_invalid_data;
+    }
+
+    _Stats->hits   = (uint64_t) InterlockedCompareExchange64(&_Cache->_Hits, 0, 0);
+    _Stats->misses = (uint64_t) InterlockedCompareExchange64(&_Cache->_Misses, 0, 0);
+    return scfg_error_success;
+}
\ No newline at end of file
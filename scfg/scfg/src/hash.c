@@ -4,351 +4,1272 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include <blake3.h>
+#include <blake3_tree.h>
+#include <hash.h>
 #include <inc/scfg.h>
+#include <io.h>
 #include <openssl/evp.h>
 #include <openssl/types.h>
 #include <openssl/whrlpool.h>
+#include <parallel.h>
 #include <scfgpch.h>
+#include <sha2.h>
+#include <sha3.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <unicode.h>
+#include <xxh3.h>
 
 #define _BLAKE3_HASH_SIZE    32 // 256-bit hash
 #define _SHA512_HASH_SIZE    64 // 512-bit hash
 #define _WHIRLPOOL_HASH_SIZE 64 // 512-bit hash
+#define _XXH3_64_HASH_SIZE   8 // 64-bit hash
+#define _XXH3_128_HASH_SIZE  16 // 128-bit hash
+#define _SHA2_256_HASH_SIZE  32 // 256-bit hash
+#define _SHA2_512_HASH_SIZE  64 // 512-bit hash
+
+#define _DEFAULT_FILE_CHUNK_SIZE 65536 // 64 KiB
+#define _UNICODE_BLOCK_SIZE      1024 // words converted at once, 4 KiB of UTF-8 at most
+
+struct scfg_hasher {
+    scfg_hash_id_t _Id;
+    union {
+        blake3_hasher _Blake3;
+        EVP_MD_CTX* _Sha512;
+        WHIRLPOOL_CTX _Whirlpool;
+        struct _Xxh3_state _Xxh3;
+        struct _Sha256_state _Sha2_256;
+        struct _Sha512_state _Sha2_512;
+    };
+};
+
+static EVP_MD* _Sha512_digest       = NULL; // fetched once, shared by all threads
+static INIT_ONCE _Sha512_digest_once = INIT_ONCE_STATIC_INIT;
+
+// Note: Each thread reuses its own context, so hashing does not allocate a context per call.
+static __declspec(thread) EVP_MD_CTX* _Sha512_ctx = NULL;
+
+static BOOL CALLBACK _Fetch_sha512_digest(INIT_ONCE* const _Once, void* const _Param, void** const _Ctx) {
+    (void) _Once;
+    (void) _Param;
+    (void) _Ctx;
+    _Sha512_digest = EVP_MD_fetch(NULL, "SHA3-512", NULL);
+    return _Sha512_digest != NULL;
+}
+
+inline const EVP_MD* _SCFG_CONV _Get_sha512_digest(void) {
+    if (!InitOnceExecuteOnce(&_Sha512_digest_once, _Fetch_sha512_digest, NULL, NULL)) {
+        return NULL;
+    }
+
+    return _Sha512_digest;
+}
+
+inline EVP_MD_CTX* _SCFG_CONV _Get_sha512_context(void) {
+    if (!_Sha512_ctx) { // the first hash on this thread
+        _Sha512_ctx = EVP_MD_CTX_new();
+    }
+
+    return _Sha512_ctx;
+}
 
 inline scfg_error_t _SCFG_CONV _Cleanup_openssl_on_failure(EVP_MD_CTX* _Ctx) {
-    EVP_MD_CTX_free(_Ctx); // release context
+    EVP_MD_CTX_reset(_Ctx); // keep context for the next hash
     return scfg_error_general_failure;
 }
 
-inline scfg_error_t _SCFG_CONV _Hash_blake3(
-    const uint8_t* const _Bytes, const size_t _Size, scfg_byte_buffer_t* const _Buf) {
-    if (!_Buf) {
-        return scfg_error_invalid_buffer;
+size_t _SCFG_CONV _Get_hash_size(const scfg_hash_id_t _Id) {
+    switch (_Id) {
+    case scfg_hash_id_blake3:
+        return _BLAKE3_HASH_SIZE;
+    case scfg_hash_id_sha512:
+        return _SHA512_HASH_SIZE;
+    case scfg_hash_id_whirlpool:
+        return _WHIRLPOOL_HASH_SIZE;
+    case scfg_hash_id_xxh3_64:
+        return _XXH3_64_HASH_SIZE;
+    case scfg_hash_id_xxh3_128:
+        return _XXH3_128_HASH_SIZE;
+    case scfg_hash_id_sha2_256:
+        return _SHA2_256_HASH_SIZE;
+    case scfg_hash_id_sha2_512:
+        return _SHA2_512_HASH_SIZE;
+    default:
+        return 0;
+    }
+}
+
+scfg_error_t _SCFG_CONV _Get_hash_buffer(
+    scfg_byte_buffer_t* const _Buf, const size_t _Hash_size, uint8_t** const _Ptr) {
+    if (!_Buf) {
+        return scfg_error_invalid_buffer;
+    }
+
+    if (_Buf->_Size < _Hash_size) {
+        return scfg_error_buffer_too_small;
+    }
+
+    return scfg_get_associated_buffer(_Buf, scfg_buffer_type_byte, _Ptr);
+}
+
+inline scfg_error_t _SCFG_CONV _Hash_blake3(
+    const uint8_t* const _Bytes, const size_t _Size, uint8_t* const _Out) {
+    blake3_hasher _Hasher;
+    blake3_hasher_init(&_Hasher);
+    blake3_hasher_update(&_Hasher, _Bytes, _Size);
+    blake3_hasher_finalize(&_Hasher, _Out, _BLAKE3_HASH_SIZE);
+    return scfg_error_success;
+}
+
+inline scfg_error_t _SCFG_CONV _Hash_sha512(
+    const uint8_t* const _Bytes, const size_t _Size, uint8_t* const _Out) {
+    const EVP_MD* const _Digest = _Get_sha512_digest();
+    if (!_Digest) {
+        return scfg_error_general_failure;
+    }
+
+    EVP_MD_CTX* const _Ctx = _Get_sha512_context();
+    if (!_Ctx) {
+        return scfg_error_not_enough_memory;
+    }
+
+    if (EVP_DigestInit_ex(_Ctx, _Digest, NULL) != 1) {
+        return _Cleanup_openssl_on_failure(_Ctx);
+    }
+
+    if (EVP_DigestUpdate(_Ctx, _Bytes, _Size) != 1) {
+        return _Cleanup_openssl_on_failure(_Ctx);
+    }
+
+    int _Len = 0; // hash size (unused)
+    if (EVP_DigestFinal_ex(_Ctx, _Out, &_Len) != 1) {
+        return _Cleanup_openssl_on_failure(_Ctx);
+    }
+
+    EVP_MD_CTX_reset(_Ctx);
+    return scfg_error_success;
+}
+
+#pragma warning(push, 3)
+#pragma warning(disable : 4996) // C4996: WHIRLPOOL_Init(), WHIRLPOOL_Update() and WHIRLPOOL_Final()
+                                //        since OpenSSL 3.0
+inline scfg_error_t _SCFG_CONV _Hash_whirlpool(
+    const uint8_t* const _Bytes, const size_t _Size, uint8_t* const _Out) {
+    WHIRLPOOL_CTX _Ctx;
+    if (WHIRLPOOL_Init(&_Ctx) != 1) {
+        return scfg_error_general_failure;
+    }
+
+    if (WHIRLPOOL_Update(&_Ctx, _Bytes, _Size) != 1) {
+        return scfg_error_general_failure;
+    }
+
+    if (WHIRLPOOL_Final(_Out, &_Ctx) != 1) {
+        return scfg_error_general_failure;
+    }
+
+    return scfg_error_success;
+}
+
+inline scfg_error_t _SCFG_CONV _Init_hasher(scfg_hasher_t* const _Hasher) {
+    switch (_Hasher->_Id) {
+    case scfg_hash_id_blake3:
+        blake3_hasher_init(&_Hasher->_Blake3);
+        return scfg_error_success;
+    case scfg_hash_id_sha512:
+        return EVP_DigestInit_ex(_Hasher->_Sha512, _Get_sha512_digest(), NULL) == 1
+                 ? scfg_error_success : scfg_error_general_failure;
+    case scfg_hash_id_whirlpool:
+        return WHIRLPOOL_Init(&_Hasher->_Whirlpool) == 1 ? scfg_error_success : scfg_error_general_failure;
+    case scfg_hash_id_xxh3_64:
+    case scfg_hash_id_xxh3_128:
+        _Xxh3_init(&_Hasher->_Xxh3);
+        return scfg_error_success;
+    case scfg_hash_id_sha2_256:
+        _Sha256_init(&_Hasher->_Sha2_256);
+        return scfg_error_success;
+    case scfg_hash_id_sha2_512:
+        _Sha512_init(&_Hasher->_Sha2_512);
+        return scfg_error_success;
+    default:
+        return scfg_error_unsupported_hash;
+    }
+}
+
+inline scfg_error_t _SCFG_CONV _Update_hasher(
+    scfg_hasher_t* const _Hasher, const uint8_t* const _Data, const size_t _Size) {
+    switch (_Hasher->_Id) {
+    case scfg_hash_id_blake3:
+        blake3_hasher_update(&_Hasher->_Blake3, _Data, _Size);
+        return scfg_error_success;
+    case scfg_hash_id_sha512:
+        return EVP_DigestUpdate(_Hasher->_Sha512, _Data, _Size) == 1
+                 ? scfg_error_success : scfg_error_general_failure;
+    case scfg_hash_id_whirlpool:
+        return WHIRLPOOL_Update(&_Hasher->_Whirlpool, _Data, _Size) == 1
+                 ? scfg_error_success : scfg_error_general_failure;
+    case scfg_hash_id_xxh3_64:
+    case scfg_hash_id_xxh3_128:
+        _Xxh3_update(&_Hasher->_Xxh3, _Data, _Size);
+        return scfg_error_success;
+    case scfg_hash_id_sha2_256:
+        _Sha256_update(&_Hasher->_Sha2_256, _Data, _Size);
+        return scfg_error_success;
+    case scfg_hash_id_sha2_512:
+        _Sha512_update(&_Hasher->_Sha2_512, _Data, _Size);
+        return scfg_error_success;
+    default:
+        return scfg_error_unsupported_hash;
+    }
+}
+
+inline scfg_error_t _SCFG_CONV _Finalize_hasher(scfg_hasher_t* const _Hasher, uint8_t* const _Out) {
+    int _Len = 0; // hash size (unused)
+    switch (_Hasher->_Id) {
+    case scfg_hash_id_blake3:
+        blake3_hasher_finalize(&_Hasher->_Blake3, _Out, _BLAKE3_HASH_SIZE);
+        return scfg_error_success;
+    case scfg_hash_id_sha512:
+        return EVP_DigestFinal_ex(_Hasher->_Sha512, _Out, &_Len) == 1
+                 ? scfg_error_success : scfg_error_general_failure;
+    case scfg_hash_id_whirlpool:
+        return WHIRLPOOL_Final(_Out, &_Hasher->_Whirlpool) == 1
+                 ? scfg_error_success : scfg_error_general_failure;
+    case scfg_hash_id_xxh3_64:
+        _Xxh3_finalize_64(&_Hasher->_Xxh3, _Out);
+        return scfg_error_success;
+    case scfg_hash_id_xxh3_128:
+        _Xxh3_finalize_128(&_Hasher->_Xxh3, _Out);
+        return scfg_error_success;
+    case scfg_hash_id_sha2_256:
+        _Sha256_finalize(&_Hasher->_Sha2_256, _Out);
+        return scfg_error_success;
+    case scfg_hash_id_sha2_512:
+        _Sha512_finalize(&_Hasher->_Sha2_512, _Out);
+        return scfg_error_success;
+    default:
+        return scfg_error_unsupported_hash;
+    }
+}
+#pragma warning(pop)
+
+inline scfg_error_t _SCFG_CONV _Reset_hasher(scfg_hasher_t* const _Hasher) {
+    if (_Hasher->_Id == scfg_hash_id_blake3) { // keep the key and mode of keyed hashers
+        blake3_hasher_reset(&_Hasher->_Blake3);
+        return scfg_error_success;
+    }
+
+    return _Init_hasher(_Hasher);
+}
+
+inline void _SCFG_CONV _Release_hasher(scfg_hasher_t* const _Hasher) {
+    if (_Hasher->_Id == scfg_hash_id_sha512) {
+        EVP_MD_CTX_free(_Hasher->_Sha512); // release context
+    }
+
+    free(_Hasher);
+}
+
+inline scfg_error_t _SCFG_CONV _Init_local_hasher(scfg_hasher_t* const _Hasher, const scfg_hash_id_t _Id) {
+    _Hasher->_Id = _Id;
+    if (_Id == scfg_hash_id_sha512) {
+        _Hasher->_Sha512 = _Get_sha512_context(); // borrowed from the calling thread
+        if (!_Hasher->_Sha512) {
+            return scfg_error_not_enough_memory;
+        }
+    }
+
+    return _Init_hasher(_Hasher);
+}
+
+inline void _SCFG_CONV _Reset_local_hasher(scfg_hasher_t* const _Hasher) {
+    if (_Hasher->_Id == scfg_hash_id_sha512) {
+        EVP_MD_CTX_reset(_Hasher->_Sha512); // keep context for the next hash
+    }
+}
+
+// Note: A sink feeds every chunk to all of its hashers. If there is more than one, they are updated
+//       concurrently on the thread pool, so a chunk takes as long as the slowest hash.
+struct _Hash_sink {
+    scfg_hasher_t* _Hashers;
+    size_t _Count;
+    PTP_WORK _Work; // NULL if all hashers are updated on the calling thread
+    const uint8_t* _Data; // the current chunk
+    size_t _Size;
+    volatile LONG _Next; // the next hasher to be updated
+    volatile LONG _Failed; // non-zero if any update failed
+};
+
+inline void _SCFG_CONV _Run_hash_sink(struct _Hash_sink* const _Sink) {
+    for (;;) {
+        const size_t _Idx = (size_t) (InterlockedIncrement(&_Sink->_Next) - 1);
+        if (_Idx >= _Sink->_Count) { // no more hashers
+            break;
+        }
+
+        if (_Update_hasher(&_Sink->_Hashers[_Idx], _Sink->_Data, _Sink->_Size) != scfg_error_success) {
+            InterlockedExchange(&_Sink->_Failed, 1);
+        }
+    }
+}
+
+static void CALLBACK _Hash_sink_worker(PTP_CALLBACK_INSTANCE _Instance, void* const _Ctx, PTP_WORK _Work) {
+    (void) _Instance;
+    (void) _Work;
+    _Run_hash_sink((struct _Hash_sink*) _Ctx);
+}
+
+inline scfg_error_t _SCFG_CONV _Update_hash_sink(
+    struct _Hash_sink* const _Sink, const uint8_t* const _Data, const size_t _Size) {
+    _Sink->_Data = _Data;
+    _Sink->_Size = _Size;
+    _Sink->_Next = 0;
+    if (_Sink->_Work) {
+        for (size_t _Idx = 1; _Idx < _Sink->_Count; ++_Idx) {
+            SubmitThreadpoolWork(_Sink->_Work);
+        }
+    }
+
+    _Run_hash_sink(_Sink); // the calling thread takes a hasher as well
+    if (_Sink->_Work) {
+        WaitForThreadpoolWorkCallbacks(_Sink->_Work, FALSE);
+    }
+
+    return _Sink->_Failed ? scfg_error_general_failure : scfg_error_success;
+}
+
+inline scfg_error_t _SCFG_CONV _Hash_stream(FILE* const _Stream, const size_t _Off,
+    struct _Hash_sink* const _Sink, uint8_t* const _Chunk, const size_t _Chunk_size) {
+    if (_fseeki64(_Stream, (__int64) _Off, SEEK_SET) != 0) { // offset may be too large for the selected file
+        return scfg_error_invalid_stream;
+    }
+
+    size_t _Read      = 0; // read bytes
+    scfg_error_t _Err = scfg_error_success;
+    for (;;) {
+        _Read = fread(_Chunk, sizeof(uint8_t), _Chunk_size, _Stream);
+        if (_Read == 0) { // no more data
+            break;
+        }
+
+        _Err = _Update_hash_sink(_Sink, _Chunk, _Read);
+        if (_Err != scfg_error_success) {
+            return _Err;
+        }
+
+        if (_Read < _Chunk_size) { // no more data
+            break;
+        }
+    }
+
+    return scfg_error_success;
+}
+
+inline scfg_error_t _SCFG_CONV _Hash_handle(
+    const HANDLE _Handle, struct _Hash_sink* const _Sink, uint8_t* const _Chunk, const size_t _Chunk_size) {
+    const DWORD _Max_read = (DWORD) _SCFG_MIN(_Chunk_size, (size_t) MAXDWORD);
+    DWORD _Read           = 0; // read bytes
+    scfg_error_t _Err     = scfg_error_success;
+    while (_Err == scfg_error_success) {
+        if (!ReadFile(_Handle, _Chunk, _Max_read, &_Read, NULL)) {
+            return scfg_error_invalid_stream;
+        }
+
+        if (_Read == 0) { // no more data
+            break;
+        }
+
+        _Err = _Update_hash_sink(_Sink, _Chunk, _Read);
+    }
+
+    return _Err;
+}
+
+inline scfg_error_t _SCFG_CONV _Hash_handle_range(const HANDLE _Handle, uint64_t _Off, uint64_t _Size,
+    struct _Hash_sink* const _Sink, uint8_t* const _Chunk, const size_t _Chunk_size) {
+    const DWORD _Max_read = (DWORD) _SCFG_MIN(_Chunk_size, (size_t) MAXDWORD);
+    DWORD _Read           = 0; // read bytes
+    scfg_error_t _Err     = scfg_error_success;
+    while (_Err == scfg_error_success && _Size > 0) {
+        // Note: An explicit offset makes each read independent of the file pointer, like pread().
+        OVERLAPPED _Overlapped = {0};
+        _Overlapped.Offset     = (DWORD) _Off;
+        _Overlapped.OffsetHigh = (DWORD) (_Off >> 32);
+        const DWORD _To_read   = (DWORD) _SCFG_MIN((uint64_t) _Max_read, _Size);
+        if (!ReadFile(_Handle, _Chunk, _To_read, &_Read, &_Overlapped)) {
+            return scfg_error_invalid_stream; // also reported when the range starts past the end of the file
+        }
+
+        if (_Read == 0) { // the range ends past the end of the file
+            return scfg_error_invalid_stream;
+        }
+
+        _Err = _Update_hash_sink(_Sink, _Chunk, _Read);
+        _Off += _Read;
+        _Size -= _Read;
+    }
+
+    return _Err;
+}
+
+scfg_error_t _SCFG_CONV _Hash_region(const HANDLE _Handle, const uint64_t _Off, const uint64_t _Size,
+    const scfg_hash_id_t _Id, uint8_t* const _Chunk, const size_t _Chunk_size, uint8_t* const _Out) {
+    scfg_hasher_t _Hasher;
+    struct _Hash_sink _Sink; // a single hasher, updated on the calling thread
+    _Sink._Hashers    = &_Hasher;
+    _Sink._Count      = 1;
+    _Sink._Work       = NULL;
+    _Sink._Failed     = 0;
+    scfg_error_t _Err = _Init_local_hasher(&_Hasher, _Id);
+    if (_Err == scfg_error_success) {
+        _Err = _Hash_handle_range(_Handle, _Off, _Size, &_Sink, _Chunk, _Chunk_size);
+        if (_Err == scfg_error_success) {
+            _Err = _Finalize_hasher(&_Hasher, _Out);
+        }
+    }
+
+    _Reset_local_hasher(&_Hasher);
+    return _Err;
+}
+
+inline scfg_error_t _SCFG_CONV _Reopen_stream(FILE* const _Stream, HANDLE* const _Handle) {
+    const intptr_t _Os_handle = _get_osfhandle(_fileno(_Stream));
+    if (_Os_handle == -1) {
+        return scfg_error_invalid_stream;
+    }
+
+    // Note: The reopened handle has its own file pointer, so the stream position is not changed.
+    //       FILE_FLAG_SEQUENTIAL_SCAN lets the system read ahead more aggressively.
+    *_Handle = ReOpenFile((HANDLE) _Os_handle, GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, FILE_FLAG_SEQUENTIAL_SCAN);
+    return *_Handle != INVALID_HANDLE_VALUE ? scfg_error_success : scfg_error_invalid_stream;
+}
+
+inline scfg_error_t _SCFG_CONV _Hash_stream_handle(FILE* const _Stream, const size_t _Off,
+    struct _Hash_sink* const _Sink, uint8_t* const _Chunk, const size_t _Chunk_size) {
+    if (fflush(_Stream) != 0) { // pending writes must reach the file first
+        return scfg_error_invalid_stream;
+    }
+
+    HANDLE _Handle;
+    scfg_error_t _Err = _Reopen_stream(_Stream, &_Handle);
+    if (_Err != scfg_error_success) {
+        return _Err;
+    }
+
+    LARGE_INTEGER _Pos;
+    _Pos.QuadPart = (LONGLONG) _Off;
+    _Err          = scfg_error_invalid_stream;
+    if (SetFilePointerEx(_Handle, _Pos, NULL, FILE_BEGIN)) {
+        _Err = _Hash_handle(_Handle, _Sink, _Chunk, _Chunk_size);
+    }
+
+    CloseHandle(_Handle);
+    return _Err;
+}
+
+inline scfg_error_t _SCFG_CONV _Hash_file(FILE* const _Stream, const size_t _Off,
+    const scfg_hash_id_t* const _Ids, scfg_byte_buffer_t* const _Bufs, const size_t _Count,
+    const scfg_file_hash_options_t* const _Options) {
+    if (!_Stream) {
+        return scfg_error_invalid_stream;
+    }
+
+    const size_t _Chunk_size = _Options && _Options->chunk_size != 0 ? _Options->chunk_size
+                                                                     : _DEFAULT_FILE_CHUNK_SIZE;
+    uint8_t* const _Chunk = (uint8_t*) malloc(_Chunk_size);
+    if (!_Chunk) {
+        return scfg_error_not_enough_memory;
+    }
+
+    struct _Hash_sink _Sink;
+    _Sink._Hashers = (scfg_hasher_t*) malloc(_Count * sizeof(scfg_hasher_t));
+    if (!_Sink._Hashers) {
+        free(_Chunk);
+        return scfg_error_not_enough_memory;
+    }
+
+    _Sink._Count      = 0;
+    _Sink._Work       = NULL;
+    _Sink._Failed     = 0;
+    scfg_error_t _Err = scfg_error_success;
+    while (_Err == scfg_error_success && _Sink._Count < _Count) {
+        _Err = _Init_local_hasher(&_Sink._Hashers[_Sink._Count], _Ids[_Sink._Count]);
+        ++_Sink._Count; // reset below, even if the initialization failed
+    }
+
+    if (_Err == scfg_error_success) {
+        if (_Count > 1) { // without a work object, all hashers are updated on the calling thread
+            _Sink._Work = CreateThreadpoolWork(_Hash_sink_worker, &_Sink, NULL);
+        }
+
+        if (_Options && _Options->bypass_stdio) {
+            _Err = _Hash_stream_handle(_Stream, _Off, &_Sink, _Chunk, _Chunk_size);
+        } else {
+            _Err = _Hash_stream(_Stream, _Off, &_Sink, _Chunk, _Chunk_size);
+        }
+
+        if (_Sink._Work) {
+            CloseThreadpoolWork(_Sink._Work);
+        }
+    }
+
+    uint8_t* _Ptr;
+    for (size_t _Idx = 0; _Idx < _Sink._Count; ++_Idx) {
+        if (_Err == scfg_error_success) {
+            _Err = scfg_get_associated_buffer(&_Bufs[_Idx], scfg_buffer_type_byte, &_Ptr);
+            if (_Err == scfg_error_success) {
+                _Err = _Finalize_hasher(&_Sink._Hashers[_Idx], _Ptr);
+            }
+        }
+
+        _Reset_local_hasher(&_Sink._Hashers[_Idx]);
+    }
+
+    free(_Sink._Hashers);
+    free(_Chunk);
+    return _Err;
+}
+
+inline scfg_error_t _SCFG_CONV _Hash_path(const wchar_t* const _Path, const scfg_hash_id_t _Id,
+    uint8_t* const _Chunk, const size_t _Chunk_size, uint8_t* const _Out) {
+    if (!_Path) {
+        return scfg_error_invalid_stream;
+    }
+
+    // Note: FILE_FLAG_SEQUENTIAL_SCAN tells the cache manager to read ahead aggressively.
+    const HANDLE _Handle = CreateFileW(_Path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (_Handle == INVALID_HANDLE_VALUE) {
+        return scfg_error_invalid_stream;
+    }
+
+    scfg_hasher_t _Hasher;
+    struct _Hash_sink _Sink; // a single hasher, updated on the calling thread
+    _Sink._Hashers    = &_Hasher;
+    _Sink._Count      = 1;
+    _Sink._Work       = NULL;
+    _Sink._Failed     = 0;
+    scfg_error_t _Err = _Init_local_hasher(&_Hasher, _Id);
+    if (_Err == scfg_error_success) {
+        _Err = _Hash_handle(_Handle, &_Sink, _Chunk, _Chunk_size);
+        if (_Err == scfg_error_success) {
+            _Err = _Finalize_hasher(&_Hasher, _Out);
+        }
+    }
+
+    _Reset_local_hasher(&_Hasher);
+    CloseHandle(_Handle);
+    return _Err;
+}
+
+inline scfg_error_t _SCFG_CONV _Hash_file_range(FILE* const _Stream, const uint64_t _Off,
+    const uint64_t _Size, const scfg_hash_id_t _Id, uint8_t* const _Out) {
+    if (!_Stream) {
+        return scfg_error_invalid_stream;
+    }
+
+    // Note: Small ranges do not need a full chunk.
+    const uint64_t _Max_size = _SCFG_MIN((uint64_t) _DEFAULT_FILE_CHUNK_SIZE, _Size);
+    const size_t _Chunk_size = (size_t) _SCFG_MAX(_Max_size, 1);
+    uint8_t* const _Chunk    = (uint8_t*) malloc(_Chunk_size);
+    if (!_Chunk) {
+        return scfg_error_not_enough_memory;
+    }
+
+    // Note: Each call reads through its own handle with explicit offsets, so neither the stream position
+    //       nor other calls on the same stream are affected. Buffered stream writes are not flushed.
+    HANDLE _Handle;
+    scfg_error_t _Err = _Reopen_stream(_Stream, &_Handle);
+    if (_Err != scfg_error_success) {
+        free(_Chunk);
+        return _Err;
+    }
+
+    _Err = _Hash_region(_Handle, _Off, _Size, _Id, _Chunk, _Chunk_size, _Out);
+    CloseHandle(_Handle);
+    free(_Chunk);
+    return _Err;
+}
+
+// Note: Workers take the next file from a shared cursor, so a thread that finishes early
+//       continues with the remaining files. Reading one file overlaps with hashing the others.
+struct _Hash_files_job {
+    const wchar_t* const* _Paths;
+    size_t _Count;
+    scfg_hash_id_t _Id;
+    size_t _Hash_size;
+    uint8_t* _Out; // hashes are stored back to back
+    scfg_error_t* _Errors; // one per file
+    volatile LONG _Next; // the next file to be hashed
+};
+
+static void _Run_hash_files_job(void* const _Ctx) {
+    struct _Hash_files_job* const _Job = (struct _Hash_files_job*) _Ctx;
+    uint8_t* const _Chunk              = (uint8_t*) malloc(_DEFAULT_FILE_CHUNK_SIZE); // reused for every file
+    for (;;) {
+        const size_t _Idx = (size_t) (InterlockedIncrement(&_Job->_Next) - 1);
+        if (_Idx >= _Job->_Count) { // no more files
+            break;
+        }
+
+        if (_Chunk) {
+            _Job->_Errors[_Idx] = _Hash_path(_Job->_Paths[_Idx], _Job->_Id, _Chunk, _DEFAULT_FILE_CHUNK_SIZE,
+                _Job->_Out + _Idx * _Job->_Hash_size);
+        } else {
+            _Job->_Errors[_Idx] = scfg_error_not_enough_memory;
+        }
+    }
+
+    free(_Chunk);
+}
+
+scfg_error_t _SCFG_CONV _Hash_bytes(
+    const uint8_t* const _Data, const size_t _Size, const scfg_hash_id_t _Id, uint8_t* const _Out) {
+    switch (_Id) {
+    case scfg_hash_id_blake3:
+        return _Hash_blake3(_Data, _Size, _Out);
+    case scfg_hash_id_sha512:
+        return _Hash_sha512(_Data, _Size, _Out);
+    case scfg_hash_id_whirlpool:
+        return _Hash_whirlpool(_Data, _Size, _Out);
+    case scfg_hash_id_xxh3_64:
+        _Xxh3_64(_Data, _Size, _Out);
+        return scfg_error_success;
+    case scfg_hash_id_xxh3_128:
+        _Xxh3_128(_Data, _Size, _Out);
+        return scfg_error_success;
+    case scfg_hash_id_sha2_256:
+        _Sha256(_Data, _Size, _Out);
+        return scfg_error_success;
+    case scfg_hash_id_sha2_512:
+        _Sha512(_Data, _Size, _Out);
+        return scfg_error_success;
+    default:
+        return scfg_error_unsupported_hash;
+    }
+}
+
+inline scfg_error_t _SCFG_CONV _Fill_blake3_output(
+    const blake3_hasher* const _Hasher, const uint64_t _Seek, scfg_byte_buffer_t* const _Buf) {
+    uint8_t* _Ptr;
+    const scfg_error_t _Err = _Get_hash_buffer(_Buf, 1, &_Ptr); // any non-empty buffer is filled
+    if (_Err != scfg_error_success) {
+        return _Err;
+    }
+
+    blake3_hasher_finalize_seek(_Hasher, _Seek, _Ptr, _Buf->_Size);
+    return scfg_error_success;
+}
+
+inline scfg_error_t _SCFG_CONV _Create_blake3_hasher(
+    const blake3_hasher* const _Base, scfg_hasher_t** const _Hasher) {
+    scfg_hasher_t* const _New_hasher = (scfg_hasher_t*) malloc(sizeof(scfg_hasher_t));
+    if (!_New_hasher) {
+        return scfg_error_not_enough_memory;
+    }
+
+    _New_hasher->_Id     = scfg_hash_id_blake3;
+    _New_hasher->_Blake3 = *_Base; // carries the key and mode
+    *_Hasher             = _New_hasher;
+    return scfg_error_success;
+}
+
+inline scfg_error_t _SCFG_CONV _Hash_bytes_parallel(const uint8_t* const _Data, const size_t _Size,
+    const scfg_hash_id_t _Id, const size_t _Thread_count, uint8_t* const _Out) {
+    if (_Id != scfg_hash_id_blake3) { // only BLAKE3 has a tree structure
+        return _Hash_bytes(_Data, _Size, _Id, _Out);
+    }
+
+    blake3_hasher _Base;
+    blake3_hasher_init(&_Base);
+    return _Hash_blake3_parallel(&_Base, _Data, _Size, _Thread_count, _Out);
+}
+
+inline scfg_error_t _SCFG_CONV _Hash_batch(const uint8_t* const* const _Data, const size_t* const _Sizes,
+    const size_t _Count, const scfg_hash_id_t _Id, const size_t _Hash_size, uint8_t* const _Out) {
+    // Note: Short BLAKE3 messages are grouped by length and each group is hashed by blake3_hash_many().
+    //       Short SHA3-512 messages are hashed four at a time and SHA-256 messages eight at a time
+    //       in AVX2 lanes. The other messages share one hasher, so the setup is paid once rather
+    //       than per message.
+    if (_Id == scfg_hash_id_sha2_256) {
+        _Sha256_many(_Data, _Sizes, _Count, _Out);
+        return scfg_error_success;
+    }
+
+    int _Batched      = 0; // messages of at most _Batch_max bytes are already hashed
+    size_t _Batch_max = 0;
+    if (_Id == scfg_hash_id_blake3) {
+        _Hash_blake3_batch(_Data, _Sizes, _Count, _Out);
+        _Batched   = 1;
+        _Batch_max = BLAKE3_CHUNK_LEN;
+    } else if (_Id == scfg_hash_id_sha512) {
+        _Batched   = _Sha3_512_batch(_Data, _Sizes, _Count, _Out);
+        _Batch_max = _SHA3_BATCH_MAX_SIZE;
+    }
+
+    scfg_hasher_t _Hasher;
+    scfg_error_t _Err = _Init_local_hasher(&_Hasher, _Id);
+    int _Finalized    = 0; // the hasher has to be initialized again
+    for (size_t _Idx = 0; _Err == scfg_error_success && _Idx < _Count; ++_Idx) {
+        if (_Batched && _Sizes[_Idx] <= _Batch_max) { // already hashed
+            continue;
+        }
+
+        if (_Finalized) {
+            _Err = _Init_hasher(&_Hasher);
+            if (_Err != scfg_error_success) {
+                break;
+            }
+        }
+
+        _Finalized = 1;
+        _Err       = _Update_hasher(&_Hasher, _Data[_Idx], _Sizes[_Idx]);
+        if (_Err == scfg_error_success) {
+            _Err = _Finalize_hasher(&_Hasher, _Out + _Idx * _Hash_size);
+        }
+    }
+
+    _Reset_local_hasher(&_Hasher);
+    return _Err;
+}
+
+inline scfg_error_t _SCFG_CONV _Hash_unicode(
+    const wchar_t* _Data, size_t _Size, const scfg_hash_id_t _Id, uint8_t* const _Out) {
+    // Note: Every word is converted on its own, so the data can be split anywhere without
+    //       changing the hash. Each block is hashed as soon as it is converted.
+    char _Block[_UNICODE_BLOCK_SIZE * _UTF8_MAX_WORD_SIZE];
+    scfg_hasher_t _Hasher;
+    scfg_error_t _Err = _Init_local_hasher(&_Hasher, _Id);
+    while (_Err == scfg_error_success && _Size > 0) {
+        const size_t _Count = _Size < _UNICODE_BLOCK_SIZE ? _Size : _UNICODE_BLOCK_SIZE;
+        size_t _Written;
+        _Err = _Unicode_to_utf8(_Data, _Count, _Block, &_Written);
+        if (_Err == scfg_error_success) {
+            _Err = _Update_hasher(&_Hasher, (const uint8_t*) _Block, _Written);
+        }
+
+        _Data += _Count;
+        _Size -= _Count;
+    }
+
+    if (_Err == scfg_error_success) {
+        _Err = _Finalize_hasher(&_Hasher, _Out);
+    }
+
+    _Reset_local_hasher(&_Hasher);
+    return _Err;
+}
+
+void _SCFG_CONV _Release_hash_context(void) {
+    EVP_MD_CTX_free(_Sha512_ctx);
+    _Sha512_ctx = NULL;
+}
+
+void _SCFG_CONV _Release_hash_algorithms(void) {
+    EVP_MD_free(_Sha512_digest);
+    _Sha512_digest = NULL;
+}
+
+__bool_t _SCFG_CONV scfg_is_valid_hash_id(const scfg_hash_id_t _Id) {
+    switch (_Id) {
+    case scfg_hash_id_blake3:
+    case scfg_hash_id_sha512:
+    case scfg_hash_id_whirlpool:
+    case scfg_hash_id_xxh3_64:
+    case scfg_hash_id_xxh3_128:
+    case scfg_hash_id_sha2_256:
+    case scfg_hash_id_sha2_512:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+scfg_error_t _SCFG_CONV scfg_get_hash_size(const scfg_hash_id_t _Id, size_t* const _Size) {
+    if (!_Size) {
+        return scfg_error_invalid_data;
     }
 
-    if (_Buf->_Size < _BLAKE3_HASH_SIZE) {
-        return scfg_error_buffer_too_small;
+    *_Size = _Get_hash_size(_Id);
+    return *_Size != 0 ? scfg_error_success : scfg_error_unsupported_hash;
+}
+
+scfg_error_t _SCFG_CONV scfg_get_hash_kernel(const scfg_hash_id_t _Id, scfg_hash_kernel_t* const _Kernel) {
+    if (!_Kernel) {
+        return scfg_error_invalid_data;
+    }
+
+    switch (_Id) {
+    case scfg_hash_id_blake3: // BLAKE3 and OpenSSL select their own kernels
+    case scfg_hash_id_sha512:
+    case scfg_hash_id_whirlpool:
+        *_Kernel = scfg_hash_kernel_external;
+        return scfg_error_success;
+    case scfg_hash_id_xxh3_64:
+    case scfg_hash_id_xxh3_128:
+        *_Kernel = _Get_xxh3_kernel();
+        return scfg_error_success;
+    case scfg_hash_id_sha2_256:
+        *_Kernel = _Get_sha256_kernel();
+        return scfg_error_success;
+    case scfg_hash_id_sha2_512:
+        *_Kernel = _Get_sha512_kernel();
+        return scfg_error_success;
+    default:
+        return scfg_error_unsupported_hash;
+    }
+}
+
+scfg_error_t _SCFG_CONV scfg_hash_bytes(const uint8_t* const _Data, const size_t _Size,
+    const scfg_hash_id_t _Id, scfg_byte_buffer_t* const _Buf) {
+    const size_t _Hash_size = _Get_hash_size(_Id);
+    if (_Hash_size == 0) {
+        return scfg_error_unsupported_hash;
     }
 
     uint8_t* _Ptr;
-    const scfg_error_t _Err = scfg_get_associated_buffer(_Buf, scfg_buffer_type_byte, &_Ptr);
+    const scfg_error_t _Err = _Get_hash_buffer(_Buf, _Hash_size, &_Ptr);
     if (_Err != scfg_error_success) {
         return _Err;
     }
 
-    blake3_hasher _Hasher;
-    blake3_hasher_init(&_Hasher);
-    blake3_hasher_update(&_Hasher, _Bytes, _Size);
-    blake3_hasher_finalize(&_Hasher, _Ptr, _BLAKE3_HASH_SIZE);
-    return scfg_error_success;
+    return _Hash_bytes(_Data, _Size, _Id, _Ptr);
 }
 
-inline scfg_error_t _SCFG_CONV _Hash_file_blake3(
-    FILE* const _Stream, const size_t _Off, scfg_byte_buffer_t* const _Buf) {
-    if (!_Stream) {
-        return scfg_error_invalid_stream;
+scfg_error_t _SCFG_CONV scfg_hash_utf8(const char* const _Data, const size_t _Size,
+    const scfg_hash_id_t _Id, scfg_byte_buffer_t* const _Buf) {
+    return scfg_hash_bytes((const uint8_t*) _Data, _Size, _Id, _Buf);
+}
+
+scfg_error_t _SCFG_CONV scfg_hash_unicode(const wchar_t* const _Data, const size_t _Size,
+    const scfg_hash_id_t _Id, scfg_byte_buffer_t* const _Buf) {
+    const size_t _Hash_size = _Get_hash_size(_Id);
+    if (_Hash_size == 0) {
+        return scfg_error_unsupported_hash;
     }
 
-    if (!_Buf) {
-        return scfg_error_invalid_buffer;
+    uint8_t* _Ptr;
+    const scfg_error_t _Err = _Get_hash_buffer(_Buf, _Hash_size, &_Ptr);
+    if (_Err != scfg_error_success) {
+        return _Err;
+    }
+
+    return _Hash_unicode(_Data, _Size, _Id, _Ptr);
+}
+
+scfg_error_t _SCFG_CONV scfg_hash_file(
+    FILE* const _Stream, const size_t _Off, const scfg_hash_id_t _Id, scfg_byte_buffer_t* const _Buf) {
+    return scfg_hash_file_with_options(_Stream, _Off, _Id, NULL, _Buf);
+}
+
+scfg_error_t _SCFG_CONV scfg_hash_file_with_options(FILE* const _Stream, const size_t _Off,
+    const scfg_hash_id_t _Id, const scfg_file_hash_options_t* const _Options,
+    scfg_byte_buffer_t* const _Buf) {
+    const size_t _Hash_size = _Get_hash_size(_Id);
+    if (_Hash_size == 0) {
+        return scfg_error_unsupported_hash;
     }
 
     uint8_t* _Ptr;
-    const scfg_error_t _Err = scfg_get_associated_buffer(_Buf, scfg_buffer_type_byte, &_Ptr);
+    const scfg_error_t _Err = _Get_hash_buffer(_Buf, _Hash_size, &_Ptr);
     if (_Err != scfg_error_success) {
         return _Err;
     }
 
-    if (fseek(_Stream, (long) _Off, SEEK_SET) != 0) { // offset may be too large for the selected file
-        return scfg_error_invalid_stream;
+    return _Hash_file(_Stream, _Off, &_Id, _Buf, 1, _Options);
+}
+
+scfg_error_t _SCFG_CONV scfg_hash_file_multi(FILE* const _Stream, const size_t _Off,
+    const scfg_hash_id_t* const _Ids, scfg_byte_buffer_t* const _Bufs, const size_t _Count,
+    const scfg_file_hash_options_t* const _Options) {
+    if (!_Ids || _Count == 0) {
+        return scfg_error_invalid_data;
     }
 
-    uint8_t _Temp_buf[1024];
-    size_t _Read = 0; // read bytes
-    blake3_hasher _Hasher;
-    blake3_hasher_init(&_Hasher);
-    for (;;) {
-        _Read = fread(_Temp_buf, sizeof(uint8_t), 1024, _Stream);
-        if (_Read == 0) { // no more data
-            break;
+    if (!_Bufs) {
+        return scfg_error_invalid_buffer;
+    }
+
+    uint8_t* _Ptr;
+    scfg_error_t _Err;
+    for (size_t _Idx = 0; _Idx < _Count; ++_Idx) {
+        const size_t _Hash_size = _Get_hash_size(_Ids[_Idx]);
+        if (_Hash_size == 0) {
+            return scfg_error_unsupported_hash;
         }
 
-        blake3_hasher_update(&_Hasher, _Temp_buf, _Read);
-        if (_Read < 1024) { // no more data
-            break;
+        for (size_t _Prev = 0; _Prev < _Idx; ++_Prev) {
+            if (_Ids[_Prev] == _Ids[_Idx]) { // each hash may be requested only once
+                return scfg_error_invalid_data;
+            }
+        }
+
+        _Err = _Get_hash_buffer(&_Bufs[_Idx], _Hash_size, &_Ptr);
+        if (_Err != scfg_error_success) {
+            return _Err;
         }
     }
 
-    blake3_hasher_finalize(&_Hasher, _Ptr, _BLAKE3_HASH_SIZE);
-    return scfg_error_success;
+    return _Hash_file(_Stream, _Off, _Ids, _Bufs, _Count, _Options);
 }
 
-inline scfg_error_t _SCFG_CONV _Hash_sha512(
-    const uint8_t* const _Bytes, const size_t _Size, scfg_byte_buffer_t* const _Buf) {
-    if (!_Buf) {
-        return scfg_error_invalid_buffer;
+scfg_error_t _SCFG_CONV scfg_hash_file_range(FILE* const _Stream, const uint64_t _Off, const uint64_t _Size,
+    const scfg_hash_id_t _Id, scfg_byte_buffer_t* const _Buf) {
+    const size_t _Hash_size = _Get_hash_size(_Id);
+    if (_Hash_size == 0) {
+        return scfg_error_unsupported_hash;
+    }
+
+    if (_Size > UINT64_MAX - _Off) { // the range would wrap around
+        return scfg_error_invalid_data;
+    }
+
+    uint8_t* _Ptr;
+    const scfg_error_t _Err = _Get_hash_buffer(_Buf, _Hash_size, &_Ptr);
+    if (_Err != scfg_error_success) {
+        return _Err;
+    }
+
+    return _Hash_file_range(_Stream, _Off, _Size, _Id, _Ptr);
+}
+
+scfg_error_t _SCFG_CONV scfg_hash_batch(const uint8_t* const* const _Data, const size_t* const _Sizes,
+    const size_t _Count, const scfg_hash_id_t _Id, scfg_byte_buffer_t* const _Buf) {
+    const size_t _Hash_size = _Get_hash_size(_Id);
+    if (_Hash_size == 0) {
+        return scfg_error_unsupported_hash;
+    }
+
+    if ((!_Data || !_Sizes) && _Count > 0) {
+        return scfg_error_invalid_data;
     }
 
-    if (_Buf->_Size < _SHA512_HASH_SIZE) {
+    if (_Count > SIZE_MAX / _Hash_size) { // the hashes would not fit in any buffer
         return scfg_error_buffer_too_small;
     }
 
     uint8_t* _Ptr;
-    const scfg_error_t _Err = scfg_get_associated_buffer(_Buf, scfg_buffer_type_byte, &_Ptr);
+    const scfg_error_t _Err = _Get_hash_buffer(_Buf, _Count * _Hash_size, &_Ptr);
     if (_Err != scfg_error_success) {
         return _Err;
     }
 
-    EVP_MD_CTX* _Ctx = EVP_MD_CTX_new();
-    if (!_Ctx) {
-        return scfg_error_not_enough_memory;
+    return _Hash_batch(_Data, _Sizes, _Count, _Id, _Hash_size, _Ptr);
+}
+
+scfg_error_t _SCFG_CONV scfg_hash_files(const wchar_t* const* const _Paths, const size_t _Count,
+    const scfg_hash_id_t _Id, const size_t _Thread_count, scfg_byte_buffer_t* const _Buf,
+    scfg_error_t* const _Errors) {
+    const size_t _Hash_size = _Get_hash_size(_Id);
+    if (_Hash_size == 0) {
+        return scfg_error_unsupported_hash;
     }
 
-    if (EVP_DigestInit_ex(_Ctx, EVP_sha3_512(), NULL) != 1) {
-        return _Cleanup_openssl_on_failure(_Ctx);
+    if ((!_Paths || !_Errors) && _Count > 0) {
+        return scfg_error_invalid_data;
     }
 
-    if (EVP_DigestUpdate(_Ctx, _Bytes, _Size) != 1) {
-        return _Cleanup_openssl_on_failure(_Ctx);
+    if (_Count > SIZE_MAX / _Hash_size) { // the hashes would not fit in any buffer
+        return scfg_error_buffer_too_small;
     }
 
-    int _Len = 0; // hash size (unused)
-    if (EVP_DigestFinal_ex(_Ctx, _Ptr, &_Len) != 1) {
-        return _Cleanup_openssl_on_failure(_Ctx);
+    uint8_t* _Ptr;
+    const scfg_error_t _Err = _Get_hash_buffer(_Buf, _Count * _Hash_size, &_Ptr);
+    if (_Err != scfg_error_success) {
+        return _Err;
+    }
+
+    struct _Hash_files_job _Job;
+    _Job._Paths     = _Paths;
+    _Job._Count     = _Count;
+    _Job._Id        = _Id;
+    _Job._Hash_size = _Hash_size;
+    _Job._Out       = _Ptr;
+    _Job._Errors    = _Errors;
+    _Job._Next      = 0;
+    _Run_on_threads(_Run_hash_files_job, &_Job, _SCFG_MIN(_Get_thread_count(_Thread_count), _Count));
+    for (size_t _Idx = 0; _Idx < _Count; ++_Idx) {
+        if (_Errors[_Idx] != scfg_error_success) { // report the first failed file
+            return _Errors[_Idx];
+        }
     }
 
-    EVP_MD_CTX_free(_Ctx);
     return scfg_error_success;
 }
 
-inline scfg_error_t _SCFG_CONV _Hash_file_sha512(
-    FILE* const _Stream, const size_t _Off, scfg_byte_buffer_t* const _Buf) {
-    if (!_Stream) {
-        return scfg_error_invalid_stream;
+scfg_error_t _SCFG_CONV scfg_hash_bytes_parallel(const uint8_t* const _Data, const size_t _Size,
+    const scfg_hash_id_t _Id, const size_t _Thread_count, scfg_byte_buffer_t* const _Buf) {
+    const size_t _Hash_size = _Get_hash_size(_Id);
+    if (_Hash_size == 0) {
+        return scfg_error_unsupported_hash;
     }
 
-    if (!_Buf) {
-        return scfg_error_invalid_buffer;
+    uint8_t* _Ptr;
+    const scfg_error_t _Err = _Get_hash_buffer(_Buf, _Hash_size, &_Ptr);
+    if (_Err != scfg_error_success) {
+        return _Err;
+    }
+
+    return _Hash_bytes_parallel(_Data, _Size, _Id, _Thread_count, _Ptr);
+}
+
+scfg_error_t _SCFG_CONV scfg_hash_file_parallel(const wchar_t* const _Path, const scfg_hash_id_t _Id,
+    const size_t _Thread_count, scfg_byte_buffer_t* const _Buf) {
+    const size_t _Hash_size = _Get_hash_size(_Id);
+    if (_Hash_size == 0) {
+        return scfg_error_unsupported_hash;
     }
 
     uint8_t* _Ptr;
-    const scfg_error_t _Err = scfg_get_associated_buffer(_Buf, scfg_buffer_type_byte, &_Ptr);
+    scfg_error_t _Err = _Get_hash_buffer(_Buf, _Hash_size, &_Ptr);
     if (_Err != scfg_error_success) {
         return _Err;
     }
 
-    if (fseek(_Stream, (long) _Off, SEEK_SET) != 0) { // offset may be too large for the selected file
+    if (!_Path) {
         return scfg_error_invalid_stream;
     }
 
-    uint8_t _Temp_buf[1024];
-    size_t _Read     = 0; // read bytes
-    EVP_MD_CTX* _Ctx = EVP_MD_CTX_new();
-    if (!_Ctx) {
-        return scfg_error_not_enough_memory;
+    if (_Id != scfg_hash_id_blake3) { // only BLAKE3 has a tree structure
+        FILE* const _Stream = _wfopen(_Path, L"rb");
+        if (!_Stream) {
+            return scfg_error_invalid_stream;
+        }
+
+        _Err = _Hash_file(_Stream, 0, &_Id, _Buf, 1, NULL);
+        fclose(_Stream);
+        return _Err;
     }
 
-    if (EVP_DigestInit_ex(_Ctx, EVP_sha3_512(), NULL) != 1) {
-        return _Cleanup_openssl_on_failure(_Ctx);
+    // Note: Workers read their subtrees with positional reads instead of mapping the file,
+    //       so the file size is not limited by the address space.
+    const HANDLE _File = CreateFileW(
+        _Path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (_File == INVALID_HANDLE_VALUE) {
+        return scfg_error_invalid_stream;
     }
 
-    for (;;) {
-        _Read = fread(_Temp_buf, sizeof(uint8_t), 1024, _Stream);
-        if (_Read == 0) { // no more data
-            break;
-        }
+    LARGE_INTEGER _File_size;
+    _Err = scfg_error_invalid_stream;
+    if (GetFileSizeEx(_File, &_File_size)) {
+        blake3_hasher _Base;
+        blake3_hasher_init(&_Base);
+        _Err = _Hash_blake3_file_parallel(&_Base, _File, (uint64_t) _File_size.QuadPart, _Thread_count, _Ptr);
+    }
 
-        if (EVP_DigestUpdate(_Ctx, _Temp_buf, _Read) != 1) {
-            return _Cleanup_openssl_on_failure(_Ctx);
-        }
+    CloseHandle(_File);
+    return _Err;
+}
 
-        if (_Read < 1024) { // no more data
-            break;
-        }
+scfg_error_t _SCFG_CONV scfg_hash_byte_view(const scfg_byte_view_t _Data, const scfg_hash_id_t _Id,
+    uint8_t* const _Out, const size_t _Out_size, scfg_byte_view_t* const _Hash) {
+    const size_t _Hash_size = _Get_hash_size(_Id);
+    if (_Hash_size == 0) {
+        return scfg_error_unsupported_hash;
     }
 
-    int _Len = 0; // hash size (unused)
-    if (EVP_DigestFinal_ex(_Ctx, _Ptr, &_Len) != 1) {
-        return _Cleanup_openssl_on_failure(_Ctx);
+    if (!_Out) {
+        return scfg_error_invalid_buffer;
     }
 
-    EVP_MD_CTX_free(_Ctx);
-    return scfg_error_success;
+    if (_Out_size < _Hash_size) {
+        return scfg_error_buffer_too_small;
+    }
+
+    const scfg_error_t _Err = _Hash_bytes(_Data.data, _Data.size, _Id, _Out);
+    if (_Err == scfg_error_success && _Hash) { // refer to the written hash
+        _Hash->data = _Out;
+        _Hash->size = _Hash_size;
+    }
+
+    return _Err;
 }
 
-#pragma warning(push, 3)
-#pragma warning(disable : 4996) // C4996: WHIRLPOOL_Init(), WHIRLPOOL_Update() and WHIRLPOOL_Final()
-                                //        since OpenSSL 3.0
-inline scfg_error_t _SCFG_CONV _Hash_whirlpool(
-    const uint8_t* const _Bytes, const size_t _Size, scfg_byte_buffer_t* const _Buf) {
-    if (!_Buf) {
+scfg_error_t _SCFG_CONV scfg_hash_utf8_view(const scfg_utf8_view_t _Data, const scfg_hash_id_t _Id,
+    uint8_t* const _Out, const size_t _Out_size, scfg_byte_view_t* const _Hash) {
+    const scfg_byte_view_t _Bytes = {(const uint8_t*) _Data.data, _Data.size};
+    return scfg_hash_byte_view(_Bytes, _Id, _Out, _Out_size, _Hash);
+}
+
+scfg_error_t _SCFG_CONV scfg_hash_unicode_view(const scfg_unicode_view_t _Data, const scfg_hash_id_t _Id,
+    uint8_t* const _Out, const size_t _Out_size, scfg_byte_view_t* const _Hash) {
+    const size_t _Hash_size = _Get_hash_size(_Id);
+    if (_Hash_size == 0) {
+        return scfg_error_unsupported_hash;
+    }
+
+    if (!_Out) {
         return scfg_error_invalid_buffer;
     }
 
-    if (_Buf->_Size < _WHIRLPOOL_HASH_SIZE) {
+    if (_Out_size < _Hash_size) {
         return scfg_error_buffer_too_small;
     }
 
-    uint8_t* _Ptr;
-    const scfg_error_t _Err = scfg_get_associated_buffer(_Buf, scfg_buffer_type_byte, &_Ptr);
-    if (_Err != scfg_error_success) {
-        return _Err;
+    const scfg_error_t _Err = _Hash_unicode(_Data.data, _Data.size, _Id, _Out);
+    if (_Err == scfg_error_success && _Hash) { // refer to the written hash
+        _Hash->data = _Out;
+        _Hash->size = _Hash_size;
     }
 
-    WHIRLPOOL_CTX _Ctx;
-    if (WHIRLPOOL_Init(&_Ctx) != 1) {
-        return scfg_error_general_failure;
+    return _Err;
+}
+
+scfg_error_t _SCFG_CONV scfg_create_hasher(const scfg_hash_id_t _Id, scfg_hasher_t** const _Hasher) {
+    if (!_Hasher) {
+        return scfg_error_invalid_hasher;
     }
 
-    if (WHIRLPOOL_Update(&_Ctx, _Bytes, _Size) != 1) {
-        return scfg_error_general_failure;
+    if (!scfg_is_valid_hash_id(_Id)) {
+        return scfg_error_unsupported_hash;
     }
 
-    if (WHIRLPOOL_Final(_Ptr, &_Ctx) != 1) {
-        return scfg_error_general_failure;
+    scfg_hasher_t* const _New_hasher = (scfg_hasher_t*) malloc(sizeof(scfg_hasher_t));
+    if (!_New_hasher) {
+        return scfg_error_not_enough_memory;
+    }
+
+    _New_hasher->_Id = _Id;
+    if (_Id == scfg_hash_id_sha512) {
+        _New_hasher->_Sha512 = EVP_MD_CTX_new();
+        if (!_New_hasher->_Sha512) {
+            free(_New_hasher);
+            return scfg_error_not_enough_memory;
+        }
     }
 
+    const scfg_error_t _Err = _Init_hasher(_New_hasher);
+    if (_Err != scfg_error_success) {
+        _Release_hasher(_New_hasher);
+        return _Err;
+    }
+
+    *_Hasher = _New_hasher;
     return scfg_error_success;
 }
 
-inline scfg_error_t _SCFG_CONV _Hash_file_whirlpool(
-    FILE* const _Stream, const size_t _Off, scfg_byte_buffer_t* const _Buf) {
-    if (!_Stream) {
-        return scfg_error_invalid_stream;
+scfg_error_t _SCFG_CONV scfg_update_hasher(
+    scfg_hasher_t* const _Hasher, const uint8_t* const _Data, const size_t _Size) {
+    if (!_Hasher) {
+        return scfg_error_invalid_hasher;
     }
 
-    if (!_Buf) {
-        return scfg_error_invalid_buffer;
+    return _Update_hasher(_Hasher, _Data, _Size);
+}
+
+scfg_error_t _SCFG_CONV scfg_finalize_hasher(scfg_hasher_t* const _Hasher, scfg_byte_buffer_t* const _Buf) {
+    if (!_Hasher) {
+        return scfg_error_invalid_hasher;
     }
 
     uint8_t* _Ptr;
-    const scfg_error_t _Err = scfg_get_associated_buffer(_Buf, scfg_buffer_type_byte, &_Ptr);
+    const scfg_error_t _Err = _Get_hash_buffer(_Buf, _Get_hash_size(_Hasher->_Id), &_Ptr);
     if (_Err != scfg_error_success) {
         return _Err;
     }
 
-    if (fseek(_Stream, (long) _Off, SEEK_SET) != 0) { // offset may be too large for the selected file
-        return scfg_error_invalid_stream;
-    }
-
-    uint8_t _Temp_buf[1024];
-    size_t _Read = 0; // read bytes
-    WHIRLPOOL_CTX _Ctx;
-    if (WHIRLPOOL_Init(&_Ctx) != 1) {
+    if (_Finalize_hasher(_Hasher, _Ptr) != scfg_error_success) {
         return scfg_error_general_failure;
     }
 
-    for (;;) {
-        _Read = fread(_Temp_buf, sizeof(uint8_t), 1024, _Stream);
-        if (_Read == 0) { // no more data
-            break;
-        }
-
-        if (WHIRLPOOL_Update(&_Ctx, _Temp_buf, _Read) != 1) {
-            return scfg_error_general_failure;
-        }
+    return _Reset_hasher(_Hasher); // start a new message
+}
 
-        if (_Read < 1024) { // no more data
-            break;
-        }
+scfg_error_t _SCFG_CONV scfg_reset_hasher(scfg_hasher_t* const _Hasher) {
+    if (!_Hasher) {
+        return scfg_error_invalid_hasher;
     }
 
-    if (WHIRLPOOL_Final(_Ptr, &_Ctx) != 1) {
-        return scfg_error_general_failure;
+    return _Reset_hasher(_Hasher);
+}
+
+scfg_error_t _SCFG_CONV scfg_release_hasher(scfg_hasher_t* const _Hasher) {
+    if (!_Hasher) {
+        return scfg_error_invalid_hasher;
     }
 
+    _Release_hasher(_Hasher);
     return scfg_error_success;
 }
-#pragma warning(pop)
 
-__bool_t _SCFG_CONV scfg_is_valid_hash_id(const scfg_hash_id_t _Id) {
-    switch (_Id) {
-    case scfg_hash_id_blake3:
-    case scfg_hash_id_sha512:
-    case scfg_hash_id_whirlpool:
-        return 1;
-    default:
-        return 0;
+scfg_error_t _SCFG_CONV scfg_hash_bytes_keyed(const uint8_t* const _Data, const size_t _Size,
+    const uint8_t* const _Key, scfg_byte_buffer_t* const _Buf) {
+    if (!_Key) {
+        return scfg_error_invalid_data;
     }
+
+    blake3_hasher _Hasher;
+    blake3_hasher_init_keyed(&_Hasher, _Key);
+    blake3_hasher_update(&_Hasher, _Data, _Size);
+    return _Fill_blake3_output(&_Hasher, 0, _Buf);
 }
 
-scfg_error_t _SCFG_CONV scfg_hash_bytes(const uint8_t* const _Data, const size_t _Size,
-    const scfg_hash_id_t _Id, scfg_byte_buffer_t* const _Buf) {
-    switch (_Id) {
-    case scfg_hash_id_blake3:
-        return _Hash_blake3(_Data, _Size, _Buf);
-    case scfg_hash_id_sha512:
-        return _Hash_sha512(_Data, _Size, _Buf);
-    case scfg_hash_id_whirlpool:
-        return _Hash_whirlpool(_Data, _Size, _Buf);
-    default:
-        return scfg_error_unsupported_hash;
+scfg_error_t _SCFG_CONV scfg_derive_key(const char* const _Context, const uint8_t* const _Material,
+    const size_t _Size, scfg_byte_buffer_t* const _Buf) {
+    if (!_Context) {
+        return scfg_error_invalid_data;
     }
+
+    blake3_hasher _Hasher;
+    blake3_hasher_init_derive_key(&_Hasher, _Context);
+    blake3_hasher_update(&_Hasher, _Material, _Size);
+    return _Fill_blake3_output(&_Hasher, 0, _Buf);
 }
 
-scfg_error_t _SCFG_CONV scfg_hash_utf8(const char* const _Data, const size_t _Size,
-    const scfg_hash_id_t _Id, scfg_byte_buffer_t* const _Buf) {
-    switch (_Id) {
-    case scfg_hash_id_blake3:
-        return _Hash_blake3((const uint8_t*) _Data, _Size, _Buf);
-    case scfg_hash_id_sha512:
-        return _Hash_sha512((const uint8_t*) _Data, _Size, _Buf);
-    case scfg_hash_id_whirlpool:
-        return _Hash_whirlpool((const uint8_t*) _Data, _Size, _Buf);
-    default:
-        return scfg_error_unsupported_hash;
-    }
+scfg_error_t _SCFG_CONV scfg_hash_bytes_xof(const uint8_t* const _Data, const size_t _Size,
+    const uint64_t _Seek, scfg_byte_buffer_t* const _Buf) {
+    blake3_hasher _Hasher;
+    blake3_hasher_init(&_Hasher);
+    blake3_hasher_update(&_Hasher, _Data, _Size);
+    return _Fill_blake3_output(&_Hasher, _Seek, _Buf);
 }
 
-scfg_error_t _SCFG_CONV scfg_hash_unicode(const wchar_t* const _Data, const size_t _Size,
-    const scfg_hash_id_t _Id, scfg_byte_buffer_t* const _Buf) {
-    size_t _Buf_size  = 0;
-    scfg_error_t _Err = scfg_unicode_to_utf8_required_buffer_size(_Data, _Size, &_Buf_size);
-    if (_Err != scfg_error_success) {
-        return _Err;
+scfg_error_t _SCFG_CONV scfg_create_keyed_hasher(const uint8_t* const _Key, scfg_hasher_t** const _Hasher) {
+    if (!_Hasher) {
+        return scfg_error_invalid_hasher;
     }
 
-    scfg_utf8_buffer_t _Temp_buf;
-    _Err = scfg_initialize_buffer(&_Temp_buf, scfg_buffer_type_utf8);
-    if (_Err != scfg_error_success) {
-        return _Err;
+    if (!_Key) {
+        return scfg_error_invalid_data;
     }
 
-    _Err = scfg_resize_buffer(&_Temp_buf, scfg_buffer_type_utf8, _Buf_size, NULL);
-    if (_Err != scfg_error_success) {
-        return _Err;
-    }
+    blake3_hasher _Base;
+    blake3_hasher_init_keyed(&_Base, _Key);
+    return _Create_blake3_hasher(&_Base, _Hasher);
+}
 
-    _Err = scfg_unicode_to_utf8(_Data, _Size, &_Temp_buf);
-    if (_Err != scfg_error_success) {
-        scfg_release_buffer(&_Temp_buf, scfg_buffer_type_utf8, NULL);
-        return _Err;
+scfg_error_t _SCFG_CONV scfg_create_derive_key_hasher(
+    const char* const _Context, scfg_hasher_t** const _Hasher) {
+    if (!_Hasher) {
+        return scfg_error_invalid_hasher;
     }
 
-    char* _Ptr;
-    _Err = scfg_get_associated_buffer(&_Temp_buf, scfg_buffer_type_utf8, &_Ptr);
-    if (_Err != scfg_error_success) {
-        scfg_release_buffer(&_Temp_buf, scfg_buffer_type_utf8, NULL);
-        return _Err;
+    if (!_Context) {
+        return scfg_error_invalid_data;
     }
 
-    _Err = scfg_hash_bytes((const uint8_t*) _Ptr, _Temp_buf._Size, _Id, _Buf);
-    scfg_release_buffer(&_Temp_buf, scfg_buffer_type_utf8, NULL);
-    return _Err;
+    blake3_hasher _Base;
+    blake3_hasher_init_derive_key(&_Base, _Context);
+    return _Create_blake3_hasher(&_Base, _Hasher);
 }
 
-scfg_error_t _SCFG_CONV scfg_hash_file(
-    FILE* const _Stream, const size_t _Off, const scfg_hash_id_t _Id, scfg_byte_buffer_t* const _Buf) {
-    switch (_Id) {
-    case scfg_hash_id_blake3:
-        return _Hash_file_blake3(_Stream, _Off, _Buf);
-    case scfg_hash_id_sha512:
-        return _Hash_file_sha512(_Stream, _Off, _Buf);
-    case scfg_hash_id_whirlpool:
-        return _Hash_file_whirlpool(_Stream, _Off, _Buf);
-    default:
+scfg_error_t _SCFG_CONV scfg_finalize_hasher_xof(
+    scfg_hasher_t* const _Hasher, const uint64_t _Seek, scfg_byte_buffer_t* const _Buf) {
+    if (!_Hasher) {
+        return scfg_error_invalid_hasher;
+    }
+
+    if (_Hasher->_Id != scfg_hash_id_blake3) { // only BLAKE3 has an extendable output
         return scfg_error_unsupported_hash;
     }
+
+    const scfg_error_t _Err = _Fill_blake3_output(&_Hasher->_Blake3, _Seek, _Buf);
+    if (_Err != scfg_error_success) {
+        return _Err;
+    }
+
+    return _Reset_hasher(_Hasher);
 }
\ No newline at end of file
@@ -0,0 +1,25 @@
+// blake3_tree.h
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef _BLAKE3_TREE_H_
+#define _BLAKE3_TREE_H_
+#include <blake3.h>
+#include <inc/scfg.h>
+#include <scfgpch.h>
+
+// hashes _Data with up to _Thread_count threads, _Base provides the key and flags, _Out receives 32 bytes
+scfg_error_t _SCFG_CONV _Hash_blake3_parallel(const blake3_hasher* const _Base, const uint8_t* const _Data,
+    const size_t _Size, const size_t _Thread_count, uint8_t* const _Out);
+
+// hashes the first _Size bytes of the file like _Hash_blake3_parallel(), each thread reads its own subtrees
+scfg_error_t _SCFG_CONV _Hash_blake3_file_parallel(const blake3_hasher* const _Base, const HANDLE _File,
+    const uint64_t _Size, const size_t _Thread_count, uint8_t* const _Out);
+
+// hashes every message of at most BLAKE3_CHUNK_LEN bytes, messages of the same length class are hashed
+// together by blake3_hash_many(), longer messages are skipped and their hashes are not written
+void _SCFG_CONV _Hash_blake3_batch(
+    const uint8_t* const* const _Data, const size_t* const _Sizes, const size_t _Count, uint8_t* const _Out);
+#endif // _BLAKE3_TREE_H_
\ No newline at end of file
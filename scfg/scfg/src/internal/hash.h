@@ -0,0 +1,32 @@
+// hash.h
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef _HASH_H_
+#define _HASH_H_
+#include <inc/scfg.h>
+#include <scfgpch.h>
+
+// returns the size of the selected hash in bytes, or 0 if the hash is not supported
+size_t _SCFG_CONV _Get_hash_size(const scfg_hash_id_t _Id);
+
+// checks that the buffer can hold _Hash_size bytes and returns its storage
+scfg_error_t _SCFG_CONV _Get_hash_buffer(
+    scfg_byte_buffer_t* const _Buf, const size_t _Hash_size, uint8_t** const _Ptr);
+
+// hashes the data in one call
+scfg_error_t _SCFG_CONV _Hash_bytes(
+    const uint8_t* const _Data, const size_t _Size, const scfg_hash_id_t _Id, uint8_t* const _Out);
+
+// hashes _Size bytes at _Off with positional reads, the file pointer of the handle is not used
+scfg_error_t _SCFG_CONV _Hash_region(const HANDLE _Handle, const uint64_t _Off, const uint64_t _Size,
+    const scfg_hash_id_t _Id, uint8_t* const _Chunk, const size_t _Chunk_size, uint8_t* const _Out);
+
+// releases the digest context cached by the calling thread, called when a thread detaches
+void _SCFG_CONV _Release_hash_context(void);
+
+// releases the fetched digest implementations, called when the library is unloaded
+void _SCFG_CONV _Release_hash_algorithms(void);
+#endif // _HASH_H_
\ No newline at end of file
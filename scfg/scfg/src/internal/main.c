@@ -3,8 +3,27 @@
 // Copyright (c) Mateusz Jandura. All rights reserved.
 // SPDX-License-Identifier: Apache-2.0
 
+#include <hash.h>
+#include <pool.h>
 #include <scfgpch.h>
 
 int _SCFG_CONV DllMain(HMODULE _Module, DWORD _Reason, void* _Reserved) {
+    switch (_Reason) {
+    case DLL_THREAD_DETACH: // release blocks and contexts cached by the exiting thread
+        _Release_hash_context();
+        _Release_pool_cache();
+        break;
+    case DLL_PROCESS_DETACH:
+        if (!_Reserved) { // the library is being unloaded, the process is not terminating
+            _Release_hash_context();
+            _Release_hash_algorithms();
+            _Release_pool_cache();
+        }
+
+        break;
+    default:
+        break;
+    }
+
     return 1;
 }
\ No newline at end of file
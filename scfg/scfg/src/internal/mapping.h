@@ -0,0 +1,13 @@
+// mapping.h
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef _MAPPING_H_
+#define _MAPPING_H_
+#include <inc/scfg.h>
+
+// unmaps the view of the file and resets the buffer
+scfg_error_t _SCFG_CONV _Unmap_file(scfg_mapped_buffer_t* const _Buf);
+#endif // _MAPPING_H_
\ No newline at end of file
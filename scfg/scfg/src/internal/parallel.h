@@ -0,0 +1,17 @@
+// parallel.h
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef _PARALLEL_H_
+#define _PARALLEL_H_
+#include <inc/scfg.h>
+
+// returns _Requested, or the number of processors if _Requested is 0
+size_t _SCFG_CONV _Get_thread_count(const size_t _Requested);
+
+// runs _Func on up to _Thread_count threads, including the calling thread, and waits for all of them
+void _SCFG_CONV _Run_on_threads(
+    void (*_Func)(void* const _Ctx), void* const _Ctx, const size_t _Thread_count);
+#endif // _PARALLEL_H_
\ No newline at end of file
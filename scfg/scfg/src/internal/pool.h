@@ -0,0 +1,13 @@
+// pool.h
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef _POOL_H_
+#define _POOL_H_
+#include <inc/scfg.h>
+
+// releases all blocks cached by the calling thread, called when a thread detaches
+void _SCFG_CONV _Release_pool_cache(void);
+#endif // _POOL_H_
\ No newline at end of file
@@ -0,0 +1,61 @@
+// sha2.h
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef _SHA2_H_
+#define _SHA2_H_
+#include <inc/scfg.h>
+
+#define _SHA256_BLOCK_SIZE 64
+#define _SHA512_BLOCK_SIZE 128
+
+struct _Sha256_state {
+    uint32_t _Hash[8];
+    uint8_t _Buffer[_SHA256_BLOCK_SIZE];
+    size_t _Buffered;
+    uint64_t _Total;
+};
+
+struct _Sha512_state {
+    uint64_t _Hash[8];
+    uint8_t _Buffer[_SHA512_BLOCK_SIZE];
+    size_t _Buffered;
+    uint64_t _Total;
+};
+
+// returns the SHA-256 kernel selected for this processor
+scfg_hash_kernel_t _SCFG_CONV _Get_sha256_kernel(void);
+
+// returns the SHA-512 kernel selected for this processor
+scfg_hash_kernel_t _SCFG_CONV _Get_sha512_kernel(void);
+
+// hashes the data in one call, _Out receives 32 bytes
+void _SCFG_CONV _Sha256(const uint8_t* const _Data, const size_t _Size, uint8_t* const _Out);
+
+// hashes each message like _Sha256(), _Out receives 32 bytes per message
+void _SCFG_CONV _Sha256_many(
+    const uint8_t* const* const _Data, const size_t* const _Sizes, const size_t _Count, uint8_t* const _Out);
+
+// prepares the state for a new message
+void _SCFG_CONV _Sha256_init(struct _Sha256_state* const _State);
+
+// appends the data to the message
+void _SCFG_CONV _Sha256_update(struct _Sha256_state* const _State, const uint8_t* _Data, size_t _Size);
+
+// pads the message and writes its hash, the state must be initialized again before reuse
+void _SCFG_CONV _Sha256_finalize(struct _Sha256_state* const _State, uint8_t* const _Out);
+
+// hashes the data in one call, _Out receives 64 bytes
+void _SCFG_CONV _Sha512(const uint8_t* const _Data, const size_t _Size, uint8_t* const _Out);
+
+// prepares the state for a new message
+void _SCFG_CONV _Sha512_init(struct _Sha512_state* const _State);
+
+// appends the data to the message
+void _SCFG_CONV _Sha512_update(struct _Sha512_state* const _State, const uint8_t* _Data, size_t _Size);
+
+// pads the message and writes its hash, the state must be initialized again before reuse
+void _SCFG_CONV _Sha512_finalize(struct _Sha512_state* const _State, uint8_t* const _Out);
+#endif // _SHA2_H_
\ No newline at end of file
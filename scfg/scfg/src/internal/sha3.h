@@ -0,0 +1,17 @@
+// sha3.h
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef _SHA3_H_
+#define _SHA3_H_
+#include <inc/scfg.h>
+
+#define _SHA3_BATCH_MAX_SIZE 4096 // longer messages are left to the hasher, they would keep one lane busy
+
+// hashes every message of at most _SHA3_BATCH_MAX_SIZE bytes with SHA3-512 in AVX2 lanes, longer messages
+// are skipped, returns 0 without writing any hash if the lanes are not available
+int _SCFG_CONV _Sha3_512_batch(
+    const uint8_t* const* const _Data, const size_t* const _Sizes, const size_t _Count, uint8_t* const _Out);
+#endif // _SHA3_H_
\ No newline at end of file
@@ -0,0 +1,17 @@
+// unicode.h
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef _UNICODE_H_
+#define _UNICODE_H_
+#include <inc/scfg.h>
+
+#define _UTF8_MAX_WORD_SIZE 4 // the longest UTF-8 sequence of a single word
+
+// converts the words to UTF-8, _Ptr must hold _UTF8_MAX_WORD_SIZE bytes per word,
+// _Written receives the number of stored bytes if it is not NULL
+scfg_error_t _SCFG_CONV _Unicode_to_utf8(
+    const wchar_t* _Data, size_t _Size, char* _Ptr, size_t* const _Written);
+#endif // _UNICODE_H_
\ No newline at end of file
@@ -0,0 +1,41 @@
+// xxh3.h
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+#ifndef _XXH3_H_
+#define _XXH3_H_
+#include <inc/scfg.h>
+
+#define _XXH3_BUFFER_SIZE 256 // 4 stripes
+
+struct _Xxh3_state {
+    uint64_t _Acc[8];
+    uint8_t _Buffer[_XXH3_BUFFER_SIZE];
+    size_t _Buffered;
+    size_t _Stripes; // stripes consumed in the current block
+    uint64_t _Total;
+};
+
+// returns the kernel used for the stripe loops, it is fixed when the library is compiled
+scfg_hash_kernel_t _SCFG_CONV _Get_xxh3_kernel(void);
+
+// hashes the data in one call, _Out receives 8 bytes
+void _SCFG_CONV _Xxh3_64(const uint8_t* const _Data, const size_t _Size, uint8_t* const _Out);
+
+// hashes the data in one call, _Out receives 16 bytes
+void _SCFG_CONV _Xxh3_128(const uint8_t* const _Data, const size_t _Size, uint8_t* const _Out);
+
+// prepares the state for a new message
+void _SCFG_CONV _Xxh3_init(struct _Xxh3_state* const _State);
+
+// appends the data to the message
+void _SCFG_CONV _Xxh3_update(struct _Xxh3_state* const _State, const uint8_t* _Data, const size_t _Size);
+
+// writes the 64-bit hash of the message, the state is not modified
+void _SCFG_CONV _Xxh3_finalize_64(const struct _Xxh3_state* const _State, uint8_t* const _Out);
+
+// writes the 128-bit hash of the message, the state is not modified
+void _SCFG_CONV _Xxh3_finalize_128(const struct _Xxh3_state* const _State, uint8_t* const _Out);
+#endif // _XXH3_H_
\ No newline at end of file
@@ -0,0 +1,475 @@
+// manifest.c
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <hash.h>
+#include <inc/scfg.h>
+#include <parallel.h>
+#include <scfgpch.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define _DEFAULT_MANIFEST_CHUNK_SIZE 1048576 // 1 MiB
+#define _MANIFEST_READ_SIZE          65536 // number of bytes read at once
+
+struct scfg_hash_manifest {
+    scfg_hash_id_t _Id;
+    size_t _Hash_size;
+    size_t _Chunk_size;
+    uint64_t _File_size;
+    size_t _Count; // number of chunks
+    uint8_t* _Hashes; // the root hash followed by the chunk hashes
+};
+
+// Note: Workers take the next chunk from a shared cursor. Each worker reads through its own handle,
+//       because reads through a single synchronous handle are serialized by the system.
+struct _Manifest_job {
+    HANDLE _File;
+    scfg_hash_id_t _Id;
+    size_t _Hash_size;
+    size_t _Chunk_size;
+    uint64_t _File_size;
+    const size_t* _Chunks; // indices of the chunks to be hashed, NULL selects every chunk
+    size_t _Count; // number of chunks to be hashed
+    uint8_t* _Out; // chunk hashes, indexed by chunk
+    volatile LONG _Next; // the next chunk to be hashed
+    volatile LONG _Err; // the first error reported by a worker
+};
+
+static void _Run_manifest_job(void* const _Ctx) {
+    struct _Manifest_job* const _Job = (struct _Manifest_job*) _Ctx;
+    const size_t _Read_size          = _SCFG_MIN(_Job->_Chunk_size, (size_t) _MANIFEST_READ_SIZE);
+    uint8_t* const _Chunk            = (uint8_t*) malloc(_Read_size);
+    const HANDLE _Handle             = ReOpenFile(_Job->_File, GENERIC_READ, FILE_SHARE_READ, 0);
+    scfg_error_t _Err                = scfg_error_success;
+    if (!_Chunk) {
+        _Err = scfg_error_not_enough_memory;
+    } else if (_Handle == INVALID_HANDLE_VALUE) {
+        _Err = scfg_error_invalid_stream;
+    }
+
+    while (_Err == scfg_error_success && _Job->_Err == scfg_error_success) {
+        const size_t _Idx = (size_t) (InterlockedIncrement(&_Job->_Next) - 1);
+        if (_Idx >= _Job->_Count) { // no more chunks
+            break;
+        }
+
+        const size_t _Chunk_idx = _Job->_Chunks ? _Job->_Chunks[_Idx] : _Idx;
+        const uint64_t _Off     = (uint64_t) _Chunk_idx * _Job->_Chunk_size;
+        const uint64_t _Size    = _SCFG_MIN((uint64_t) _Job->_Chunk_size, _Job->_File_size - _Off);
+        _Err = _Hash_region(_Handle, _Off, _Size, _Job->_Id, _Chunk, _Read_size,
+            _Job->_Out + _Chunk_idx * _Job->_Hash_size);
+    }
+
+    if (_Err != scfg_error_success) { // keep the first error
+        InterlockedCompareExchange(&_Job->_Err, (LONG) _Err, (LONG) scfg_error_success);
+    }
+
+    if (_Handle != INVALID_HANDLE_VALUE) {
+        CloseHandle(_Handle);
+    }
+
+    free(_Chunk);
+}
+
+inline scfg_error_t _SCFG_CONV _Open_manifest_file(
+    const wchar_t* const _Path, HANDLE* const _Handle, uint64_t* const _File_size) {
+    if (!_Path) {
+        return scfg_error_invalid_stream;
+    }
+
+    // Note: Other processes may read the file, but cannot modify it while it is being hashed.
+    *_Handle = CreateFileW(
+        _Path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (*_Handle == INVALID_HANDLE_VALUE) {
+        return scfg_error_invalid_stream;
+    }
+
+    LARGE_INTEGER _Size;
+    if (!GetFileSizeEx(*_Handle, &_Size)) {
+        CloseHandle(*_Handle);
+        return scfg_error_invalid_stream;
+    }
+
+    *_File_size = (uint64_t) _Size.QuadPart;
+    return scfg_error_success;
+}
+
+inline scfg_error_t _SCFG_CONV _Get_chunk_count(
+    const scfg_hash_manifest_t* const _Manifest, const uint64_t _File_size, size_t* const _Count) {
+    const uint64_t _Chunk_size = (uint64_t) _Manifest->_Chunk_size;
+    const uint64_t _Chunks     = _File_size / _Chunk_size + (_File_size % _Chunk_size != 0 ? 1 : 0);
+    if (_Chunks > (uint64_t) MAXLONG || _Chunks >= SIZE_MAX / _Manifest->_Hash_size) { // too many chunks
+        return scfg_error_not_enough_memory;
+    }
+
+    *_Count = (size_t) _Chunks;
+    return scfg_error_success;
+}
+
+inline scfg_error_t _SCFG_CONV _Hash_chunks(const scfg_hash_manifest_t* const _Manifest, const HANDLE _File,
+    const uint64_t _File_size, const size_t* const _Chunks, const size_t _Count, const size_t _Thread_count,
+    uint8_t* const _Out) {
+    struct _Manifest_job _Job;
+    _Job._File       = _File;
+    _Job._Id         = _Manifest->_Id;
+    _Job._Hash_size  = _Manifest->_Hash_size;
+    _Job._Chunk_size = _Manifest->_Chunk_size;
+    _Job._File_size  = _File_size;
+    _Job._Chunks     = _Chunks;
+    _Job._Count      = _Count;
+    _Job._Out        = _Out;
+    _Job._Next       = 0;
+    _Job._Err        = scfg_error_success;
+    if (_Count > 0) {
+        _Run_on_threads(_Run_manifest_job, &_Job, _SCFG_MIN(_Get_thread_count(_Thread_count), _Count));
+    }
+
+    return (scfg_error_t) _Job._Err;
+}
+
+inline scfg_error_t _SCFG_CONV _Hash_manifest_file(const scfg_hash_manifest_t* const _Manifest,
+    const HANDLE _File, const uint64_t _File_size, const size_t* const _Chunks, const size_t _Count,
+    const size_t _Chunk_count, const size_t _Thread_count, uint8_t* const _Hashes) {
+    const size_t _Hash_size = _Manifest->_Hash_size;
+    const scfg_error_t _Err =
+        _Hash_chunks(_Manifest, _File, _File_size, _Chunks, _Count, _Thread_count, _Hashes + _Hash_size);
+    if (_Err != scfg_error_success) {
+        return _Err;
+    }
+
+    return _Hash_bytes(_Hashes + _Hash_size, _Chunk_count * _Hash_size, _Manifest->_Id, _Hashes); // the root
+}
+
+inline void _SCFG_CONV _Mark_chunks(size_t* const _Chunks, const size_t _First, const size_t _Last) {
+    for (size_t _Idx = _First; _Idx <= _Last; ++_Idx) {
+        _Chunks[_Idx] = 1;
+    }
+}
+
+inline size_t _SCFG_CONV _Find_modified_chunks(const scfg_hash_manifest_t* const _Manifest,
+    const uint64_t _File_size, const size_t _Count, const uint64_t* const _Offsets,
+    const uint64_t* const _Sizes, const size_t _Range_count, size_t* const _Chunks) {
+    for (size_t _Idx = 0; _Idx < _Count; ++_Idx) {
+        _Chunks[_Idx] = 0;
+    }
+
+    if (_Count == 0) {
+        return 0;
+    }
+
+    const uint64_t _Chunk_size = (uint64_t) _Manifest->_Chunk_size;
+    if (_File_size != _Manifest->_File_size) { // every chunk past the shorter size has changed its extent
+        const uint64_t _First = _SCFG_MIN(_File_size, _Manifest->_File_size) / _Chunk_size;
+        if (_First < _Count) {
+            _Mark_chunks(_Chunks, (size_t) _First, _Count - 1);
+        }
+    }
+
+    for (size_t _Idx = 0; _Idx < _Range_count; ++_Idx) {
+        if (_Sizes[_Idx] == 0 || _Offsets[_Idx] >= _File_size) { // nothing left to rehash
+            continue;
+        }
+
+        const uint64_t _Last = (_Offsets[_Idx] + (_Sizes[_Idx] - 1)) / _Chunk_size;
+        _Mark_chunks(_Chunks, (size_t) (_Offsets[_Idx] / _Chunk_size), (size_t) _SCFG_MIN(_Last, _Count - 1));
+    }
+
+    // Note: The flags are replaced by the indices of the marked chunks. An index is never stored
+    //       after the flag it replaces, so the array can be compacted in place.
+    size_t _Marked = 0;
+    for (size_t _Idx = 0; _Idx < _Count; ++_Idx) {
+        if (_Chunks[_Idx] != 0) {
+            _Chunks[_Marked++] = _Idx;
+        }
+    }
+
+    return _Marked;
+}
+
+scfg_error_t _SCFG_CONV scfg_create_hash_manifest(const wchar_t* const _Path, const scfg_hash_id_t _Id,
+    const size_t _Chunk_size, const size_t _Thread_count, scfg_hash_manifest_t** const _Manifest) {
+    if (!_Manifest) {
+        return scfg_error_invalid_manifest;
+    }
+
+    const size_t _Hash_size = _Get_hash_size(_Id);
+    if (_Hash_size == 0) {
+        return scfg_error_unsupported_hash;
+    }
+
+    HANDLE _File;
+    uint64_t _File_size;
+    scfg_error_t _Err = _Open_manifest_file(_Path, &_File, &_File_size);
+    if (_Err != scfg_error_success) {
+        return _Err;
+    }
+
+    scfg_hash_manifest_t* const _New_manifest = (scfg_hash_manifest_t*) malloc(sizeof(scfg_hash_manifest_t));
+    if (!_New_manifest) {
+        CloseHandle(_File);
+        return scfg_error_not_enough_memory;
+    }
+
+    _New_manifest->_Id         = _Id;
+    _New_manifest->_Hash_size  = _Hash_size;
+    _New_manifest->_Chunk_size = _Chunk_size != 0 ? _Chunk_size : _DEFAULT_MANIFEST_CHUNK_SIZE;
+    _New_manifest->_File_size  = _File_size;
+    _New_manifest->_Count      = 0;
+    _New_manifest->_Hashes     = NULL;
+    _Err                       = _Get_chunk_count(_New_manifest, _File_size, &_New_manifest->_Count);
+    if (_Err == scfg_error_success) {
+        _New_manifest->_Hashes = (uint8_t*) malloc((_New_manifest->_Count + 1) * _Hash_size);
+        if (_New_manifest->_Hashes) {
+            _Err = _Hash_manifest_file(_New_manifest, _File, _File_size, NULL, _New_manifest->_Count,
+                _New_manifest->_Count, _Thread_count, _New_manifest->_Hashes);
+        } else {
+            _Err = scfg_error_not_enough_memory;
+        }
+    }
+
+    CloseHandle(_File);
+    if (_Err != scfg_error_success) {
+        free(_New_manifest->_Hashes);
+        free(_New_manifest);
+        return _Err;
+    }
+
+    *_Manifest = _New_manifest;
+    return scfg_error_success;
+}
+
+scfg_error_t _SCFG_CONV scfg_load_hash_manifest(const scfg_hash_id_t _Id, const size_t _Chunk_size,
+    const uint64_t _File_size, const uint8_t* const _Chunk_hashes, const size_t _Count,
+    const uint8_t* const _Root, scfg_hash_manifest_t** const _Manifest) {
+    if (!_Manifest) {
+        return scfg_error_invalid_manifest;
+    }
+
+    const size_t _Hash_size = _Get_hash_size(_Id);
+    if (_Hash_size == 0) {
+        return scfg_error_unsupported_hash;
+    }
+
+    if (!_Chunk_hashes && _Count > 0) {
+        return scfg_error_invalid_data;
+    }
+
+    scfg_hash_manifest_t* const _New_manifest = (scfg_hash_manifest_t*) malloc(sizeof(scfg_hash_manifest_t));
+    if (!_New_manifest) {
+        return scfg_error_not_enough_memory;
+    }
+
+    // Note: The stored chunk hashes must cover the whole file, and the root is computed again,
+    //       so a manifest that was cut short or corrupted is rejected.
+    _New_manifest->_Id         = _Id;
+    _New_manifest->_Hash_size  = _Hash_size;
+    _New_manifest->_Chunk_size = _Chunk_size != 0 ? _Chunk_size : _DEFAULT_MANIFEST_CHUNK_SIZE;
+    _New_manifest->_File_size  = _File_size;
+    _New_manifest->_Count      = 0;
+    _New_manifest->_Hashes     = NULL;
+    scfg_error_t _Err          = _Get_chunk_count(_New_manifest, _File_size, &_New_manifest->_Count);
+    if (_Err == scfg_error_success && _New_manifest->_Count != _Count) {
+        _Err = scfg_error_invalid_manifest;
+    }
+
+    if (_Err == scfg_error_success) {
+        _New_manifest->_Hashes = (uint8_t*) malloc((_Count + 1) * _Hash_size);
+        if (_New_manifest->_Hashes) {
+            if (_Count > 0) {
+                memcpy(_New_manifest->_Hashes + _Hash_size, _Chunk_hashes, _Count * _Hash_size);
+            }
+
+            _Err = _Hash_bytes(_New_manifest->_Hashes + _Hash_size, _Count * _Hash_size, _Id,
+                _New_manifest->_Hashes);
+            if (_Err == scfg_error_success && _Root
+                && memcmp(_New_manifest->_Hashes, _Root, _Hash_size) != 0) { // the stored root is stale
+                _Err = scfg_error_invalid_manifest;
+            }
+        } else {
+            _Err = scfg_error_not_enough_memory;
+        }
+    }
+
+    if (_Err != scfg_error_success) {
+        free(_New_manifest->_Hashes);
+        free(_New_manifest);
+        return _Err;
+    }
+
+    *_Manifest = _New_manifest;
+    return scfg_error_success;
+}
+
+scfg_error_t _SCFG_CONV scfg_update_hash_manifest(scfg_hash_manifest_t* const _Manifest,
+    const wchar_t* const _Path, const uint64_t* const _Offsets, const uint64_t* const _Sizes,
+    const size_t _Count, const size_t _Thread_count) {
+    if (!_Manifest) {
+        return scfg_error_invalid_manifest;
+    }
+
+    if ((!_Offsets || !_Sizes) && _Count > 0) {
+        return scfg_error_invalid_data;
+    }
+
+    for (size_t _Idx = 0; _Idx < _Count; ++_Idx) {
+        if (_Sizes[_Idx] > UINT64_MAX - _Offsets[_Idx]) { // the range would wrap around
+            return scfg_error_invalid_data;
+        }
+    }
+
+    HANDLE _File;
+    uint64_t _File_size;
+    scfg_error_t _Err = _Open_manifest_file(_Path, &_File, &_File_size);
+    if (_Err != scfg_error_success) {
+        return _Err;
+    }
+
+    // Note: The chunks are rehashed into a new array, so the manifest is not changed on failure.
+    size_t _Chunk_count;
+    uint8_t* _Hashes = NULL;
+    size_t* _Chunks  = NULL;
+    _Err             = _Get_chunk_count(_Manifest, _File_size, &_Chunk_count);
+    if (_Err == scfg_error_success) {
+        _Hashes = (uint8_t*) malloc((_Chunk_count + 1) * _Manifest->_Hash_size);
+        _Chunks = (size_t*) malloc(_SCFG_MAX(_Chunk_count, 1) * sizeof(size_t));
+        if (_Hashes && _Chunks) {
+            const size_t _Modified = _Find_modified_chunks(
+                _Manifest, _File_size, _Chunk_count, _Offsets, _Sizes, _Count, _Chunks);
+            memcpy(_Hashes + _Manifest->_Hash_size, _Manifest->_Hashes + _Manifest->_Hash_size,
+                _SCFG_MIN(_Chunk_count, _Manifest->_Count) * _Manifest->_Hash_size);
+            _Err = _Hash_manifest_file(
+                _Manifest, _File, _File_size, _Chunks, _Modified, _Chunk_count, _Thread_count, _Hashes);
+        } else {
+            _Err = scfg_error_not_enough_memory;
+        }
+    }
+
+    CloseHandle(_File);
+    free(_Chunks);
+    if (_Err != scfg_error_success) {
+        free(_Hashes);
+        return _Err;
+    }
+
+    free(_Manifest->_Hashes);
+    _Manifest->_File_size = _File_size;
+    _Manifest->_Count     = _Chunk_count;
+    _Manifest->_Hashes    = _Hashes;
+    return scfg_error_success;
+}
+
+scfg_error_t _SCFG_CONV scfg_verify_hash_manifest(const scfg_hash_manifest_t* const _Manifest,
+    const wchar_t* const _Path, const size_t _Thread_count, size_t* const _Mismatches) {
+    if (!_Manifest) {
+        return scfg_error_invalid_manifest;
+    }
+
+    if (!_Mismatches) {
+        return scfg_error_invalid_data;
+    }
+
+    HANDLE _File;
+    uint64_t _File_size;
+    scfg_error_t _Err = _Open_manifest_file(_Path, &_File, &_File_size);
+    if (_Err != scfg_error_success) {
+        return _Err;
+    }
+
+    size_t _Chunk_count;
+    uint8_t* _Hashes = NULL;
+    _Err             = _Get_chunk_count(_Manifest, _File_size, &_Chunk_count);
+    if (_Err == scfg_error_success) {
+        _Hashes = (uint8_t*) malloc((_Chunk_count + 1) * _Manifest->_Hash_size);
+        if (_Hashes) {
+            _Err = _Hash_chunks(_Manifest, _File, _File_size, NULL, _Chunk_count, _Thread_count,
+                _Hashes + _Manifest->_Hash_size);
+        } else {
+            _Err = scfg_error_not_enough_memory;
+        }
+    }
+
+    CloseHandle(_File);
+    if (_Err == scfg_error_success) { // chunks that were added or removed count as mismatches
+        const size_t _Hash_size = _Manifest->_Hash_size;
+        const size_t _Common    = _SCFG_MIN(_Chunk_count, _Manifest->_Count);
+        size_t _Count           = _SCFG_MAX(_Chunk_count, _Manifest->_Count) - _Common;
+        for (size_t _Idx = 1; _Idx <= _Common; ++_Idx) { // the root is stored first
+            const size_t _Pos = _Idx * _Hash_size;
+            if (memcmp(_Hashes + _Pos, _Manifest->_Hashes + _Pos, _Hash_size) != 0) {
+                ++_Count;
+            }
+        }
+
+        *_Mismatches = _Count;
+    }
+
+    free(_Hashes);
+    return _Err;
+}
+
+scfg_error_t _SCFG_CONV scfg_get_hash_manifest_root(
+    const scfg_hash_manifest_t* const _Manifest, scfg_byte_buffer_t* const _Buf) {
+    if (!_Manifest) {
+        return scfg_error_invalid_manifest;
+    }
+
+    uint8_t* _Ptr;
+    const scfg_error_t _Err = _Get_hash_buffer(_Buf, _Manifest->_Hash_size, &_Ptr);
+    if (_Err != scfg_error_success) {
+        return _Err;
+    }
+
+    memcpy(_Ptr, _Manifest->_Hashes, _Manifest->_Hash_size);
+    return scfg_error_success;
+}
+
+scfg_error_t _SCFG_CONV scfg_get_hash_manifest_info(const scfg_hash_manifest_t* const _Manifest,
+    scfg_hash_id_t* const _Id, size_t* const _Chunk_size, uint64_t* const _File_size) {
+    if (!_Manifest) {
+        return scfg_error_invalid_manifest;
+    }
+
+    if (!_Id || !_Chunk_size || !_File_size) {
+        return scfg_error_invalid_data;
+    }
+
+    *_Id         = _Manifest->_Id;
+    *_Chunk_size = _Manifest->_Chunk_size;
+    *_File_size  = _Manifest->_File_size;
+    return scfg_error_success;
+}
+
+scfg_error_t _SCFG_CONV scfg_get_hash_manifest_chunks(
+    const scfg_hash_manifest_t* const _Manifest, scfg_byte_buffer_t* const _Buf, size_t* const _Count) {
+    if (!_Manifest) {
+        return scfg_error_invalid_manifest;
+    }
+
+    if (!_Count) {
+        return scfg_error_invalid_data;
+    }
+
+    *_Count = _Manifest->_Count; // stored even if the buffer is too small
+    uint8_t* _Ptr;
+    const scfg_error_t _Err = _Get_hash_buffer(_Buf, _Manifest->_Count * _Manifest->_Hash_size, &_Ptr);
+    if (_Err != scfg_error_success) {
+        return _Err;
+    }
+
+    memcpy(_Ptr, _Manifest->_Hashes + _Manifest->_Hash_size, _Manifest->_Count * _Manifest->_Hash_size);
+    return scfg_error_success;
+}
+
+scfg_error_t _SCFG_CONV scfg_release_hash_manifest(scfg_hash_manifest_t* const _Manifest) {
+    if (!_Manifest) {
+        return scfg_error_invalid_manifest;
+    }
+
+    free(_Manifest->_Hashes);
+    free(_Manifest);
+    return scfg_error_success;
+}
\ No newline at end of file
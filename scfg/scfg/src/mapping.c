@@ -0,0 +1,87 @@
+// mapping.c
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <inc/scfg.h>
+#include <mapping.h>
+#include <scfgpch.h>
+#include <stddef.h>
+#include <stdint.h>
+
+inline scfg_error_t _SCFG_CONV _Cleanup_mapping_on_failure(HANDLE _File, HANDLE _Mapping) {
+    if (_Mapping) {
+        CloseHandle(_Mapping);
+    }
+
+    CloseHandle(_File);
+    return scfg_error_invalid_stream;
+}
+
+scfg_error_t _SCFG_CONV _Unmap_file(scfg_mapped_buffer_t* const _Buf) {
+    if (_Buf->_Ptr) { // an empty file is never mapped
+        UnmapViewOfFile(_Buf->_Ptr);
+    }
+
+    _Buf->_Ptr  = NULL;
+    _Buf->_Size = 0;
+    return scfg_error_success;
+}
+
+scfg_error_t _SCFG_CONV scfg_map_file(const wchar_t* const _Path, scfg_mapped_buffer_t* const _Buf) {
+    if (!_Buf) {
+        return scfg_error_invalid_buffer;
+    }
+
+    if (!_Path) {
+        return scfg_error_invalid_stream;
+    }
+
+    // Note: FILE_FLAG_SEQUENTIAL_SCAN tells the cache manager to read ahead aggressively.
+    const HANDLE _File = CreateFileW(_Path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    if (_File == INVALID_HANDLE_VALUE) {
+        return scfg_error_invalid_stream;
+    }
+
+    LARGE_INTEGER _File_size;
+    if (!GetFileSizeEx(_File, &_File_size)) {
+        return _Cleanup_mapping_on_failure(_File, NULL);
+    }
+
+    if ((uint64_t) _File_size.QuadPart > SIZE_MAX) { // the file does not fit into the address space
+        CloseHandle(_File);
+        return scfg_error_not_enough_memory;
+    }
+
+    if (_File_size.QuadPart == 0) { // an empty file cannot be mapped
+        CloseHandle(_File);
+        _Buf->_Ptr  = NULL;
+        _Buf->_Size = 0;
+        return scfg_error_success;
+    }
+
+    const HANDLE _Mapping = CreateFileMappingW(_File, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!_Mapping) {
+        return _Cleanup_mapping_on_failure(_File, NULL);
+    }
+
+    const uint8_t* const _Ptr = (const uint8_t*) MapViewOfFile(_Mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!_Ptr) {
+        return _Cleanup_mapping_on_failure(_File, _Mapping);
+    }
+
+    // Note: The view keeps the file mapping alive, both handles can be closed right away.
+    CloseHandle(_Mapping);
+    CloseHandle(_File);
+    _Buf->_Ptr  = _Ptr;
+    _Buf->_Size = (size_t) _File_size.QuadPart;
+
+    // Note: Ask the memory manager to start reading the whole file in the background. This is only
+    //       a hint, hashing still works if the prefetch is not supported or fails.
+    WIN32_MEMORY_RANGE_ENTRY _Range;
+    _Range.VirtualAddress = (void*) _Ptr;
+    _Range.NumberOfBytes  = _Buf->_Size;
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &_Range, 0);
+    return scfg_error_success;
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+// parallel.c
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <inc/scfg.h>
+#include <parallel.h>
+#include <scfgpch.h>
+#include <stddef.h>
+
+struct _Thread_job {
+    void (*_Func)(void* const _Ctx);
+    void* _Ctx;
+};
+
+static void CALLBACK _Thread_worker(PTP_CALLBACK_INSTANCE _Instance, void* const _Ctx, PTP_WORK _Work) {
+    (void) _Instance;
+    (void) _Work;
+    const struct _Thread_job* const _Job = (const struct _Thread_job*) _Ctx;
+    _Job->_Func(_Job->_Ctx);
+}
+
+size_t _SCFG_CONV _Get_thread_count(const size_t _Requested) {
+    if (_Requested != 0) {
+        return _Requested;
+    }
+
+    SYSTEM_INFO _Info;
+    GetSystemInfo(&_Info);
+    return (size_t) _Info.dwNumberOfProcessors;
+}
+
+void _SCFG_CONV _Run_on_threads(
+    void (*_Func)(void* const _Ctx), void* const _Ctx, const size_t _Thread_count) {
+    // Note: _Func must take work from a shared queue until it is empty. If no work object
+    //       can be created, the calling thread does all of the work on its own.
+    struct _Thread_job _Job = {_Func, _Ctx};
+    PTP_WORK _Work          = _Thread_count > 1 ? CreateThreadpoolWork(_Thread_worker, &_Job, NULL) : NULL;
+    if (_Work) {
+        for (size_t _Idx = 1; _Idx < _Thread_count; ++_Idx) {
+            SubmitThreadpoolWork(_Work);
+        }
+    }
+
+    _Func(_Ctx);
+    if (_Work) {
+        WaitForThreadpoolWorkCallbacks(_Work, FALSE);
+        CloseThreadpoolWork(_Work);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,135 @@
+// pool.c
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <inc/scfg.h>
+#include <pool.h>
+#include <scfgpch.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define _POOL_MIN_BLOCK_SIZE   32 // the smallest size class
+#define _POOL_CLASS_COUNT      16 // size classes from 32 bytes to 1 MiB
+#define _POOL_MAX_BLOCK_SIZE   ((size_t) _POOL_MIN_BLOCK_SIZE << (_POOL_CLASS_COUNT - 1))
+#define _POOL_CLASS_CACHE_SIZE 1048576 // the maximum number of bytes cached per size class and thread
+
+struct _Pool_node {
+    struct _Pool_node* _Next;
+};
+
+struct _Pool_cache {
+    struct _Pool_node* _Free[_POOL_CLASS_COUNT]; // free blocks of each size class
+    size_t _Count[_POOL_CLASS_COUNT]; // number of free blocks of each size class
+};
+
+// Note: Each thread owns its free lists, so allocating a cached block takes no lock.
+static __declspec(thread) struct _Pool_cache _Cache;
+
+inline size_t _SCFG_CONV _Get_pool_size_class(const size_t _Size) {
+    size_t _Class = 0;
+    while (((size_t) _POOL_MIN_BLOCK_SIZE << _Class) < _Size) {
+        ++_Class;
+    }
+
+    return _Class;
+}
+
+inline size_t _SCFG_CONV _Get_pool_class_size(const size_t _Class) {
+    return (size_t) _POOL_MIN_BLOCK_SIZE << _Class;
+}
+
+static void* _Pool_allocate(void* const _Ctx, const size_t _Size, const size_t _Align) {
+    (void) _Ctx;
+    if (_Align > _SCFG_DEFAULT_ALIGNMENT) { // malloc() does not guarantee a stricter alignment
+        return NULL;
+    }
+
+    if (_Size > _POOL_MAX_BLOCK_SIZE) { // too large to be pooled
+        return malloc(_Size);
+    }
+
+    const size_t _Class      = _Get_pool_size_class(_Size);
+    struct _Pool_node* _Node = _Cache._Free[_Class];
+    if (_Node) { // reuse a cached block
+        _Cache._Free[_Class] = _Node->_Next;
+        --_Cache._Count[_Class];
+        return _Node;
+    }
+
+    return malloc(_Get_pool_class_size(_Class));
+}
+
+static void _Pool_deallocate(void* const _Ctx, void* const _Ptr, const size_t _Size) {
+    (void) _Ctx;
+    if (_Size > _POOL_MAX_BLOCK_SIZE) { // the block was not pooled
+        free(_Ptr);
+        return;
+    }
+
+    const size_t _Class = _Get_pool_size_class(_Size);
+    if (_Cache._Count[_Class] * _Get_pool_class_size(_Class) >= _POOL_CLASS_CACHE_SIZE) { // cache is full
+        free(_Ptr);
+        return;
+    }
+
+    struct _Pool_node* const _Node = (struct _Pool_node*) _Ptr;
+    _Node->_Next                   = _Cache._Free[_Class];
+    _Cache._Free[_Class]           = _Node;
+    ++_Cache._Count[_Class];
+}
+
+static void* _Pool_reallocate(void* const _Ctx, void* const _Ptr, const size_t _Old_size,
+    const size_t _New_size, const size_t _Align) {
+    if (_Old_size <= _POOL_MAX_BLOCK_SIZE && _New_size <= _POOL_MAX_BLOCK_SIZE
+        && _Get_pool_size_class(_Old_size) == _Get_pool_size_class(_New_size)) { // the block is large enough
+        return _Ptr;
+    }
+
+    if (_Old_size > _POOL_MAX_BLOCK_SIZE && _New_size > _POOL_MAX_BLOCK_SIZE) { // neither block is pooled
+        return realloc(_Ptr, _New_size);
+    }
+
+    void* const _New_ptr = _Pool_allocate(_Ctx, _New_size, _Align);
+    if (!_New_ptr) { // the old block is still valid
+        return NULL;
+    }
+
+    memcpy(_New_ptr, _Ptr, _SCFG_MIN(_Old_size, _New_size));
+    _Pool_deallocate(_Ctx, _Ptr, _Old_size);
+    return _New_ptr;
+}
+
+void _SCFG_CONV _Release_pool_cache(void) {
+    for (size_t _Class = 0; _Class < _POOL_CLASS_COUNT; ++_Class) {
+        struct _Pool_node* _Node = _Cache._Free[_Class];
+        while (_Node) {
+            struct _Pool_node* const _Next = _Node->_Next;
+            free(_Node);
+            _Node = _Next;
+        }
+
+        _Cache._Free[_Class]  = NULL;
+        _Cache._Count[_Class] = 0;
+    }
+}
+
+scfg_error_t _SCFG_CONV scfg_get_pool_allocator(scfg_allocator_t* const _Al) {
+    if (!_Al) {
+        return scfg_error_invalid_allocator;
+    }
+
+    _Al->version    = _SCFG_ALLOCATOR_VERSION;
+    _Al->context    = NULL; // the state is kept per thread
+    _Al->allocate   = _Pool_allocate;
+    _Al->deallocate = _Pool_deallocate;
+    _Al->reallocate = _Pool_reallocate;
+    return scfg_error_success;
+}
+
+scfg_error_t _SCFG_CONV scfg_trim_pool_allocator(void) {
+    _Release_pool_cache();
+    return scfg_error_success;
+}
\ No newline at end of file
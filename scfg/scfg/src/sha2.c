@@ -0,0 +1,814 @@
+// sha2.c
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <inc/scfg.h>
+#include <intrin.h>
+#include <scfgpch.h>
+#include <sha2.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#if defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#define _SHA2_X86 1 // kernels that are selected with CPUID
+#else // ^^^ x86 ^^^ / vvv !x86 vvv
+#define _SHA2_X86 0
+#endif // x86
+
+#define _SHA256_LANES 8 // messages hashed at once by _Sha256_many()
+
+static const uint32_t _Sha256_constants[64] = {
+    0x428A2F98, 0x71374491, 0xB5C0FBCF, 0xE9B5DBA5, 0x3956C25B, 0x59F111F1, 0x923F82A4, 0xAB1C5ED5,
+    0xD807AA98, 0x12835B01, 0x243185BE, 0x550C7DC3, 0x72BE5D74, 0x80DEB1FE, 0x9BDC06A7, 0xC19BF174,
+    0xE49B69C1, 0xEFBE4786, 0x0FC19DC6, 0x240CA1CC, 0x2DE92C6F, 0x4A7484AA, 0x5CB0A9DC, 0x76F988DA,
+    0x983E5152, 0xA831C66D, 0xB00327C8, 0xBF597FC7, 0xC6E00BF3, 0xD5A79147, 0x06CA6351, 0x14292967,
+    0x27B70A85, 0x2E1B2138, 0x4D2C6DFC, 0x53380D13, 0x650A7354, 0x766A0ABB, 0x81C2C92E, 0x92722C85,
+    0xA2BFE8A1, 0xA81A664B, 0xC24B8B70, 0xC76C51A3, 0xD192E819, 0xD6990624, 0xF40E3585, 0x106AA070,
+    0x19A4C116, 0x1E376C08, 0x2748774C, 0x34B0BCB5, 0x391C0CB3, 0x4ED8AA4A, 0x5B9CCA4F, 0x682E6FF3,
+    0x748F82EE, 0x78A5636F, 0x84C87814, 0x8CC70208, 0x90BEFFFA, 0xA4506CEB, 0xBEF9A3F7, 0xC67178F2};
+
+static const uint32_t _Sha256_initial_hash[8] = {
+    0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A, 0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19};
+
+static const uint64_t _Sha512_constants[80] = {
+    0x428A2F98D728AE22, 0x7137449123EF65CD, 0xB5C0FBCFEC4D3B2F, 0xE9B5DBA58189DBBC,
+    0x3956C25BF348B538, 0x59F111F1B605D019, 0x923F82A4AF194F9B, 0xAB1C5ED5DA6D8118,
+    0xD807AA98A3030242, 0x12835B0145706FBE, 0x243185BE4EE4B28C, 0x550C7DC3D5FFB4E2,
+    0x72BE5D74F27B896F, 0x80DEB1FE3B1696B1, 0x9BDC06A725C71235, 0xC19BF174CF692694,
+    0xE49B69C19EF14AD2, 0xEFBE4786384F25E3, 0x0FC19DC68B8CD5B5, 0x240CA1CC77AC9C65,
+    0x2DE92C6F592B0275, 0x4A7484AA6EA6E483, 0x5CB0A9DCBD41FBD4, 0x76F988DA831153B5,
+    0x983E5152EE66DFAB, 0xA831C66D2DB43210, 0xB00327C898FB213F, 0xBF597FC7BEEF0EE4,
+    0xC6E00BF33DA88FC2, 0xD5A79147930AA725, 0x06CA6351E003826F, 0x142929670A0E6E70,
+    0x27B70A8546D22FFC, 0x2E1B21385C26C926, 0x4D2C6DFC5AC42AED, 0x53380D139D95B3DF,
+    0x650A73548BAF63DE, 0x766A0ABB3C77B2A8, 0x81C2C92E47EDAEE6, 0x92722C851482353B,
+    0xA2BFE8A14CF10364, 0xA81A664BBC423001, 0xC24B8B70D0F89791, 0xC76C51A30654BE30,
+    0xD192E819D6EF5218, 0xD69906245565A910, 0xF40E35855771202A, 0x106AA07032BBD1B8,
+    0x19A4C116B8D2D0C8, 0x1E376C085141AB53, 0x2748774CDF8EEB99, 0x34B0BCB5E19B48A8,
+    0x391C0CB3C5C95A63, 0x4ED8AA4AE3418ACB, 0x5B9CCA4F7763E373, 0x682E6FF3D6B2B8A3,
+    0x748F82EE5DEFB2FC, 0x78A5636F43172F60, 0x84C87814A1F0AB72, 0x8CC702081A6439EC,
+    0x90BEFFFA23631E28, 0xA4506CEBDE82BDE9, 0xBEF9A3F7B2C67915, 0xC67178F2E372532B,
+    0xCA273ECEEA26619C, 0xD186B8C721C0C207, 0xEADA7DD6CDE0EB1E, 0xF57D4F7FEE6ED178,
+    0x06F067AA72176FBA, 0x0A637DC5A2C898A6, 0x113F9804BEF90DAE, 0x1B710B35131C471B,
+    0x28DB77F523047D84, 0x32CAAB7B40C72493, 0x3C9EBE0A15C9BEBC, 0x431D67C49C100D4C,
+    0x4CC5D4BECB3E42B6, 0x597F299CFC657E2A, 0x5FCB6FAB3AD6FAEC, 0x6C44198C4A475817};
+
+static scfg_hash_kernel_t _Sha256_kernel       = scfg_hash_kernel_portable;
+static scfg_hash_kernel_t _Sha256_batch_kernel = scfg_hash_kernel_portable; // used by _Sha256_many()
+static scfg_hash_kernel_t _Sha512_kernel       = scfg_hash_kernel_portable;
+static INIT_ONCE _Sha2_kernel_once             = INIT_ONCE_STATIC_INIT;
+
+static BOOL CALLBACK _Select_sha2_kernels(INIT_ONCE* const _Once, void* const _Param, void** const _Ctx) {
+    (void) _Once;
+    (void) _Param;
+    (void) _Ctx;
+#if _SHA2_X86
+    int _Info[4];
+    __cpuid(_Info, 0);
+    if (_Info[0] < 7) { // no extended features
+        return TRUE;
+    }
+
+    __cpuid(_Info, 1);
+    const int _Features = _Info[2];
+    __cpuidex(_Info, 7, 0);
+    const int _Extended_features = _Info[1];
+    if ((_Extended_features & (1 << 29)) && (_Features & (1 << 19)) && (_Features & (1 << 9))) {
+        _Sha256_kernel = scfg_hash_kernel_sha_ni; // SHA extensions, SSE4.1 and SSSE3
+    }
+
+    // Note: AVX2 also requires the operating system to save the YMM registers (OSXSAVE and XCR0).
+    if ((_Extended_features & (1 << 5)) && (_Features & (1 << 27)) && (_Features & (1 << 28))
+        && (_xgetbv(0) & 0x6) == 0x6) {
+        _Sha512_kernel = scfg_hash_kernel_avx2;
+        if (_Sha256_kernel != scfg_hash_kernel_sha_ni) { // the SHA extensions beat eight AVX2 lanes
+            _Sha256_batch_kernel = scfg_hash_kernel_avx2;
+        }
+    }
+#endif // _SHA2_X86
+    return TRUE;
+}
+
+scfg_hash_kernel_t _SCFG_CONV _Get_sha256_kernel(void) {
+    InitOnceExecuteOnce(&_Sha2_kernel_once, _Select_sha2_kernels, NULL, NULL); // cannot fail
+    return _Sha256_kernel;
+}
+
+inline scfg_hash_kernel_t _SCFG_CONV _Get_sha256_batch_kernel(void) {
+    InitOnceExecuteOnce(&_Sha2_kernel_once, _Select_sha2_kernels, NULL, NULL); // cannot fail
+    return _Sha256_batch_kernel;
+}
+
+scfg_hash_kernel_t _SCFG_CONV _Get_sha512_kernel(void) {
+    InitOnceExecuteOnce(&_Sha2_kernel_once, _Select_sha2_kernels, NULL, NULL);
+    return _Sha512_kernel;
+}
+
+inline uint32_t _SCFG_CONV _Load_be32(const uint8_t* const _Ptr) {
+    uint32_t _Val;
+    memcpy(&_Val, _Ptr, sizeof(uint32_t));
+    return _byteswap_ulong(_Val); // Windows is always little-endian
+}
+
+inline uint64_t _SCFG_CONV _Load_be64(const uint8_t* const _Ptr) {
+    uint64_t _Val;
+    memcpy(&_Val, _Ptr, sizeof(uint64_t));
+    return _byteswap_uint64(_Val);
+}
+
+inline void _SCFG_CONV _Store_be32(const uint32_t _Val, uint8_t* const _Out) {
+    const uint32_t _Swapped = _byteswap_ulong(_Val);
+    memcpy(_Out, &_Swapped, sizeof(uint32_t));
+}
+
+inline void _SCFG_CONV _Store_be64(const uint64_t _Val, uint8_t* const _Out) {
+    const uint64_t _Swapped = _byteswap_uint64(_Val);
+    memcpy(_Out, &_Swapped, sizeof(uint64_t));
+}
+
+// Note: Rounds are unrolled eight at a time, so the working variables rotate by renaming
+//       rather than by copying.
+inline void _SCFG_CONV _Sha256_round(const uint32_t _A, const uint32_t _B, const uint32_t _C,
+    uint32_t* const _D, const uint32_t _E, const uint32_t _F, const uint32_t _G, uint32_t* const _H,
+    const uint32_t _Word) {
+    const uint32_t _Temp1 =
+        *_H + (_rotr(_E, 6) ^ _rotr(_E, 11) ^ _rotr(_E, 25)) + ((_E & _F) ^ (~_E & _G)) + _Word;
+    const uint32_t _Temp2 =
+        (_rotr(_A, 2) ^ _rotr(_A, 13) ^ _rotr(_A, 22)) + ((_A & _B) ^ (_A & _C) ^ (_B & _C));
+    *_D += _Temp1;
+    *_H = _Temp1 + _Temp2;
+}
+
+inline void _SCFG_CONV _Sha256_blocks_portable(uint32_t* const _Hash, const uint8_t* _Data, size_t _Count) {
+    uint32_t _Words[64];
+    for (; _Count > 0; --_Count, _Data += _SHA256_BLOCK_SIZE) {
+        for (size_t _Idx = 0; _Idx < 16; ++_Idx) {
+            _Words[_Idx] = _Load_be32(_Data + 4 * _Idx);
+        }
+
+        for (size_t _Idx = 16; _Idx < 64; ++_Idx) {
+            const uint32_t _Sigma0 =
+                _rotr(_Words[_Idx - 15], 7) ^ _rotr(_Words[_Idx - 15], 18) ^ (_Words[_Idx - 15] >> 3);
+            const uint32_t _Sigma1 =
+                _rotr(_Words[_Idx - 2], 17) ^ _rotr(_Words[_Idx - 2], 19) ^ (_Words[_Idx - 2] >> 10);
+            _Words[_Idx] = _Words[_Idx - 16] + _Sigma0 + _Words[_Idx - 7] + _Sigma1;
+        }
+
+        uint32_t _A = _Hash[0];
+        uint32_t _B = _Hash[1];
+        uint32_t _C = _Hash[2];
+        uint32_t _D = _Hash[3];
+        uint32_t _E = _Hash[4];
+        uint32_t _F = _Hash[5];
+        uint32_t _G = _Hash[6];
+        uint32_t _H = _Hash[7];
+        for (size_t _Idx = 0; _Idx < 64; _Idx += 8) {
+            const uint32_t* const _Constants = _Sha256_constants + _Idx;
+            _Sha256_round(_A, _B, _C, &_D, _E, _F, _G, &_H, _Constants[0] + _Words[_Idx]);
+            _Sha256_round(_H, _A, _B, &_C, _D, _E, _F, &_G, _Constants[1] + _Words[_Idx + 1]);
+            _Sha256_round(_G, _H, _A, &_B, _C, _D, _E, &_F, _Constants[2] + _Words[_Idx + 2]);
+            _Sha256_round(_F, _G, _H, &_A, _B, _C, _D, &_E, _Constants[3] + _Words[_Idx + 3]);
+            _Sha256_round(_E, _F, _G, &_H, _A, _B, _C, &_D, _Constants[4] + _Words[_Idx + 4]);
+            _Sha256_round(_D, _E, _F, &_G, _H, _A, _B, &_C, _Constants[5] + _Words[_Idx + 5]);
+            _Sha256_round(_C, _D, _E, &_F, _G, _H, _A, &_B, _Constants[6] + _Words[_Idx + 6]);
+            _Sha256_round(_B, _C, _D, &_E, _F, _G, _H, &_A, _Constants[7] + _Words[_Idx + 7]);
+        }
+
+        _Hash[0] += _A;
+        _Hash[1] += _B;
+        _Hash[2] += _C;
+        _Hash[3] += _D;
+        _Hash[4] += _E;
+        _Hash[5] += _F;
+        _Hash[6] += _G;
+        _Hash[7] += _H;
+    }
+}
+
+inline void _SCFG_CONV _Sha512_round(const uint64_t _A, const uint64_t _B, const uint64_t _C,
+    uint64_t* const _D, const uint64_t _E, const uint64_t _F, const uint64_t _G, uint64_t* const _H,
+    const uint64_t _Word) {
+    const uint64_t _Temp1 =
+        *_H + (_rotr64(_E, 14) ^ _rotr64(_E, 18) ^ _rotr64(_E, 41)) + ((_E & _F) ^ (~_E & _G)) + _Word;
+    const uint64_t _Temp2 =
+        (_rotr64(_A, 28) ^ _rotr64(_A, 34) ^ _rotr64(_A, 39)) + ((_A & _B) ^ (_A & _C) ^ (_B & _C));
+    *_D += _Temp1;
+    *_H = _Temp1 + _Temp2;
+}
+
+inline void _SCFG_CONV _Sha512_compress(uint64_t* const _Hash, const uint64_t* const _Words) {
+    uint64_t _A = _Hash[0];
+    uint64_t _B = _Hash[1];
+    uint64_t _C = _Hash[2];
+    uint64_t _D = _Hash[3];
+    uint64_t _E = _Hash[4];
+    uint64_t _F = _Hash[5];
+    uint64_t _G = _Hash[6];
+    uint64_t _H = _Hash[7];
+    for (size_t _Idx = 0; _Idx < 80; _Idx += 8) {
+        const uint64_t* const _Constants = _Sha512_constants + _Idx;
+        _Sha512_round(_A, _B, _C, &_D, _E, _F, _G, &_H, _Constants[0] + _Words[_Idx]);
+        _Sha512_round(_H, _A, _B, &_C, _D, _E, _F, &_G, _Constants[1] + _Words[_Idx + 1]);
+        _Sha512_round(_G, _H, _A, &_B, _C, _D, _E, &_F, _Constants[2] + _Words[_Idx + 2]);
+        _Sha512_round(_F, _G, _H, &_A, _B, _C, _D, &_E, _Constants[3] + _Words[_Idx + 3]);
+        _Sha512_round(_E, _F, _G, &_H, _A, _B, _C, &_D, _Constants[4] + _Words[_Idx + 4]);
+        _Sha512_round(_D, _E, _F, &_G, _H, _A, _B, &_C, _Constants[5] + _Words[_Idx + 5]);
+        _Sha512_round(_C, _D, _E, &_F, _G, _H, _A, &_B, _Constants[6] + _Words[_Idx + 6]);
+        _Sha512_round(_B, _C, _D, &_E, _F, _G, _H, &_A, _Constants[7] + _Words[_Idx + 7]);
+    }
+
+    _Hash[0] += _A;
+    _Hash[1] += _B;
+    _Hash[2] += _C;
+    _Hash[3] += _D;
+    _Hash[4] += _E;
+    _Hash[5] += _F;
+    _Hash[6] += _G;
+    _Hash[7] += _H;
+}
+
+inline void _SCFG_CONV _Sha512_blocks_portable(uint64_t* const _Hash, const uint8_t* _Data, size_t _Count) {
+    uint64_t _Words[80];
+    for (; _Count > 0; --_Count, _Data += _SHA512_BLOCK_SIZE) {
+        for (size_t _Idx = 0; _Idx < 16; ++_Idx) {
+            _Words[_Idx] = _Load_be64(_Data + 8 * _Idx);
+        }
+
+        for (size_t _Idx = 16; _Idx < 80; ++_Idx) {
+            const uint64_t _Sigma0 =
+                _rotr64(_Words[_Idx - 15], 1) ^ _rotr64(_Words[_Idx - 15], 8) ^ (_Words[_Idx - 15] >> 7);
+            const uint64_t _Sigma1 =
+                _rotr64(_Words[_Idx - 2], 19) ^ _rotr64(_Words[_Idx - 2], 61) ^ (_Words[_Idx - 2] >> 6);
+            _Words[_Idx] = _Words[_Idx - 16] + _Sigma0 + _Words[_Idx - 7] + _Sigma1;
+        }
+
+        _Sha512_compress(_Hash, _Words);
+    }
+}
+
+#if _SHA2_X86
+inline void _SCFG_CONV _Sha256_schedule_sha_ni(
+    __m128i* const _Msg0, const __m128i _Msg1, const __m128i _Msg2, const __m128i _Msg3) {
+    const __m128i _Prev7 = _mm_alignr_epi8(_Msg3, _Msg2, 4); // words t-7 to t-4
+    const __m128i _Sum   = _mm_add_epi32(_mm_sha256msg1_epu32(*_Msg0, _Msg1), _Prev7);
+    *_Msg0               = _mm_sha256msg2_epu32(_Sum, _Msg3);
+}
+
+inline void _SCFG_CONV _Sha256_rounds_sha_ni(
+    __m128i* const _Abef, __m128i* const _Cdgh, const __m128i _Msg, const uint32_t* const _Constants) {
+    const __m128i _Words = _mm_add_epi32(_Msg, _mm_loadu_si128((const __m128i*) _Constants));
+    *_Cdgh               = _mm_sha256rnds2_epu32(*_Cdgh, *_Abef, _Words);
+    *_Abef = _mm_sha256rnds2_epu32(*_Abef, *_Cdgh, _mm_shuffle_epi32(_Words, 0x0E)); // the upper two words
+}
+
+inline void _SCFG_CONV _Sha256_blocks_sha_ni(uint32_t* const _Hash, const uint8_t* _Data, size_t _Count) {
+    // Note: The SHA extensions keep the state as ABEF and CDGH rather than ABCD and EFGH.
+    const __m128i _Swap = _mm_set_epi64x(0x0C0D0E0F08090A0B, 0x0405060700010203);
+    const __m128i _Dcba = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*) _Hash), 0xB1);
+    const __m128i _Efgh = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*) (_Hash + 4)), 0x1B);
+    __m128i _Abef       = _mm_alignr_epi8(_Dcba, _Efgh, 8);
+    __m128i _Cdgh       = _mm_blend_epi16(_Efgh, _Dcba, 0xF0);
+    for (; _Count > 0; --_Count, _Data += _SHA256_BLOCK_SIZE) {
+        const __m128i _Abef_save = _Abef;
+        const __m128i _Cdgh_save = _Cdgh;
+        __m128i _Msg0            = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) _Data), _Swap);
+        __m128i _Msg1            = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (_Data + 16)), _Swap);
+        __m128i _Msg2            = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (_Data + 32)), _Swap);
+        __m128i _Msg3            = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (_Data + 48)), _Swap);
+        for (size_t _Round = 0; _Round < 64; _Round += 16) {
+            if (_Round > 0) { // the first 16 words come from the block
+                _Sha256_schedule_sha_ni(&_Msg0, _Msg1, _Msg2, _Msg3);
+            }
+
+            _Sha256_rounds_sha_ni(&_Abef, &_Cdgh, _Msg0, _Sha256_constants + _Round);
+            if (_Round > 0) {
+                _Sha256_schedule_sha_ni(&_Msg1, _Msg2, _Msg3, _Msg0);
+            }
+
+            _Sha256_rounds_sha_ni(&_Abef, &_Cdgh, _Msg1, _Sha256_constants + _Round + 4);
+            if (_Round > 0) {
+                _Sha256_schedule_sha_ni(&_Msg2, _Msg3, _Msg0, _Msg1);
+            }
+
+            _Sha256_rounds_sha_ni(&_Abef, &_Cdgh, _Msg2, _Sha256_constants + _Round + 8);
+            if (_Round > 0) {
+                _Sha256_schedule_sha_ni(&_Msg3, _Msg0, _Msg1, _Msg2);
+            }
+
+            _Sha256_rounds_sha_ni(&_Abef, &_Cdgh, _Msg3, _Sha256_constants + _Round + 12);
+        }
+
+        _Abef = _mm_add_epi32(_Abef, _Abef_save);
+        _Cdgh = _mm_add_epi32(_Cdgh, _Cdgh_save);
+    }
+
+    const __m128i _Feba = _mm_shuffle_epi32(_Abef, 0x1B);
+    const __m128i _Dchg = _mm_shuffle_epi32(_Cdgh, 0xB1);
+    _mm_storeu_si128((__m128i*) _Hash, _mm_blend_epi16(_Feba, _Dchg, 0xF0));
+    _mm_storeu_si128((__m128i*) (_Hash + 4), _mm_alignr_epi8(_Dchg, _Feba, 8));
+}
+
+inline __m256i _SCFG_CONV _Rotr64_avx2(const __m256i _Val, const int _Shift) {
+    return _mm256_or_si256(_mm256_srli_epi64(_Val, _Shift), _mm256_slli_epi64(_Val, 64 - _Shift));
+}
+
+inline __m128i _SCFG_CONV _Rotr64_sse2(const __m128i _Val, const int _Shift) {
+    return _mm_or_si128(_mm_srli_epi64(_Val, _Shift), _mm_slli_epi64(_Val, 64 - _Shift));
+}
+
+inline __m256i _SCFG_CONV _Sha512_sigma0_avx2(const __m256i _Val) {
+    return _mm256_xor_si256(
+        _mm256_xor_si256(_Rotr64_avx2(_Val, 1), _Rotr64_avx2(_Val, 8)), _mm256_srli_epi64(_Val, 7));
+}
+
+inline __m128i _SCFG_CONV _Sha512_sigma1_sse2(const __m128i _Val) {
+    return _mm_xor_si128(
+        _mm_xor_si128(_Rotr64_sse2(_Val, 19), _Rotr64_sse2(_Val, 61)), _mm_srli_epi64(_Val, 6));
+}
+
+inline __m256i _SCFG_CONV _Next_words_avx2(const __m256i _First, const __m256i _Second) {
+    // returns words 1 to 3 of _First followed by word 0 of _Second
+    return _mm256_permute4x64_epi64(_mm256_blend_epi32(_First, _Second, 0x03), _MM_SHUFFLE(0, 3, 2, 1));
+}
+
+inline __m256i _SCFG_CONV _Sha512_schedule_avx2(__m256i* const _Window) {
+    // Note: The window holds the last 16 words. The last two of the four new words depend on the
+    //       first two, so sigma1 is added in two steps.
+    const __m256i _Prev15 = _Next_words_avx2(_Window[0], _Window[1]);
+    const __m256i _Prev7  = _Next_words_avx2(_Window[2], _Window[3]);
+    const __m256i _Sigma0 = _Sha512_sigma0_avx2(_Prev15);
+    const __m256i _Sum    = _mm256_add_epi64(_mm256_add_epi64(_Window[0], _Prev7), _Sigma0);
+    const __m128i _Low    = _mm_add_epi64(
+        _mm256_castsi256_si128(_Sum), _Sha512_sigma1_sse2(_mm256_extracti128_si256(_Window[3], 1)));
+    const __m128i _High   = _mm_add_epi64(_mm256_extracti128_si256(_Sum, 1), _Sha512_sigma1_sse2(_Low));
+    _Window[0]            = _Window[1];
+    _Window[1]            = _Window[2];
+    _Window[2]            = _Window[3];
+    _Window[3]            = _mm256_inserti128_si256(_mm256_castsi128_si256(_Low), _High, 1);
+    return _Window[3];
+}
+
+inline void _SCFG_CONV _Sha512_blocks_avx2(uint64_t* const _Hash, const uint8_t* _Data, size_t _Count) {
+    // Note: AVX2 computes the message schedule and adds the round constants four words at a time.
+    //       The schedule runs 16 words ahead of the rounds, so the vector and scalar units overlap.
+    const __m256i _Swap = _mm256_set_epi64x(
+        0x08090A0B0C0D0E0F, 0x0001020304050607, 0x08090A0B0C0D0E0F, 0x0001020304050607);
+    const __m256i* const _Constants = (const __m256i*) _Sha512_constants;
+    uint64_t _Words[80]; // words with the round constants added
+    for (; _Count > 0; --_Count, _Data += _SHA512_BLOCK_SIZE) {
+        __m256i _Window[4];
+        for (size_t _Idx = 0; _Idx < 4; ++_Idx) {
+            _Window[_Idx] = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*) _Data + _Idx), _Swap);
+            _mm256_storeu_si256((__m256i*) _Words + _Idx,
+                _mm256_add_epi64(_Window[_Idx], _mm256_loadu_si256(_Constants + _Idx)));
+        }
+
+        uint64_t _A = _Hash[0];
+        uint64_t _B = _Hash[1];
+        uint64_t _C = _Hash[2];
+        uint64_t _D = _Hash[3];
+        uint64_t _E = _Hash[4];
+        uint64_t _F = _Hash[5];
+        uint64_t _G = _Hash[6];
+        uint64_t _H = _Hash[7];
+        for (size_t _Idx = 0; _Idx < 80; _Idx += 8) {
+            for (size_t _Next = _Idx / 4 + 4; _Next < _Idx / 4 + 6 && _Next < 20; ++_Next) { // 16 words ahead
+                _mm256_storeu_si256((__m256i*) _Words + _Next,
+                    _mm256_add_epi64(_Sha512_schedule_avx2(_Window), _mm256_loadu_si256(_Constants + _Next)));
+            }
+
+            _Sha512_round(_A, _B, _C, &_D, _E, _F, _G, &_H, _Words[_Idx]);
+            _Sha512_round(_H, _A, _B, &_C, _D, _E, _F, &_G, _Words[_Idx + 1]);
+            _Sha512_round(_G, _H, _A, &_B, _C, _D, _E, &_F, _Words[_Idx + 2]);
+            _Sha512_round(_F, _G, _H, &_A, _B, _C, _D, &_E, _Words[_Idx + 3]);
+            _Sha512_round(_E, _F, _G, &_H, _A, _B, _C, &_D, _Words[_Idx + 4]);
+            _Sha512_round(_D, _E, _F, &_G, _H, _A, _B, &_C, _Words[_Idx + 5]);
+            _Sha512_round(_C, _D, _E, &_F, _G, _H, _A, &_B, _Words[_Idx + 6]);
+            _Sha512_round(_B, _C, _D, &_E, _F, _G, _H, &_A, _Words[_Idx + 7]);
+        }
+
+        _Hash[0] += _A;
+        _Hash[1] += _B;
+        _Hash[2] += _C;
+        _Hash[3] += _D;
+        _Hash[4] += _E;
+        _Hash[5] += _F;
+        _Hash[6] += _G;
+        _Hash[7] += _H;
+    }
+}
+
+inline __m256i _SCFG_CONV _Rotr32_avx2(const __m256i _Val, const int _Shift) {
+    return _mm256_or_si256(_mm256_srli_epi32(_Val, _Shift), _mm256_slli_epi32(_Val, 32 - _Shift));
+}
+
+inline __m256i _SCFG_CONV _Xor3_avx2(const __m256i _First, const __m256i _Second, const __m256i _Third) {
+    return _mm256_xor_si256(_mm256_xor_si256(_First, _Second), _Third);
+}
+
+inline void _SCFG_CONV _Transpose_words_avx2(__m256i* const _Rows) {
+    // transposes 8x8 words, row N receives word N of every row
+    const __m256i _Pair0 = _mm256_unpacklo_epi32(_Rows[0], _Rows[1]);
+    const __m256i _Pair1 = _mm256_unpackhi_epi32(_Rows[0], _Rows[1]);
+    const __m256i _Pair2 = _mm256_unpacklo_epi32(_Rows[2], _Rows[3]);
+    const __m256i _Pair3 = _mm256_unpackhi_epi32(_Rows[2], _Rows[3]);
+    const __m256i _Pair4 = _mm256_unpacklo_epi32(_Rows[4], _Rows[5]);
+    const __m256i _Pair5 = _mm256_unpackhi_epi32(_Rows[4], _Rows[5]);
+    const __m256i _Pair6 = _mm256_unpacklo_epi32(_Rows[6], _Rows[7]);
+    const __m256i _Pair7 = _mm256_unpackhi_epi32(_Rows[6], _Rows[7]);
+    const __m256i _Quad0 = _mm256_unpacklo_epi64(_Pair0, _Pair2); // words 0 and 4 of rows 0 to 3
+    const __m256i _Quad1 = _mm256_unpackhi_epi64(_Pair0, _Pair2); // words 1 and 5
+    const __m256i _Quad2 = _mm256_unpacklo_epi64(_Pair1, _Pair3); // words 2 and 6
+    const __m256i _Quad3 = _mm256_unpackhi_epi64(_Pair1, _Pair3); // words 3 and 7
+    const __m256i _Quad4 = _mm256_unpacklo_epi64(_Pair4, _Pair6); // the same for rows 4 to 7
+    const __m256i _Quad5 = _mm256_unpackhi_epi64(_Pair4, _Pair6);
+    const __m256i _Quad6 = _mm256_unpacklo_epi64(_Pair5, _Pair7);
+    const __m256i _Quad7 = _mm256_unpackhi_epi64(_Pair5, _Pair7);
+    _Rows[0]             = _mm256_permute2x128_si256(_Quad0, _Quad4, 0x20);
+    _Rows[1]             = _mm256_permute2x128_si256(_Quad1, _Quad5, 0x20);
+    _Rows[2]             = _mm256_permute2x128_si256(_Quad2, _Quad6, 0x20);
+    _Rows[3]             = _mm256_permute2x128_si256(_Quad3, _Quad7, 0x20);
+    _Rows[4]             = _mm256_permute2x128_si256(_Quad0, _Quad4, 0x31);
+    _Rows[5]             = _mm256_permute2x128_si256(_Quad1, _Quad5, 0x31);
+    _Rows[6]             = _mm256_permute2x128_si256(_Quad2, _Quad6, 0x31);
+    _Rows[7]             = _mm256_permute2x128_si256(_Quad3, _Quad7, 0x31);
+}
+
+inline void _SCFG_CONV _Sha256_compress_avx2(__m256i* const _State, const uint8_t* const* const _Blocks) {
+    // Note: Each vector holds the same word of eight messages, so every lane compresses a block of
+    //       its own message. The message schedule is kept as a window of the last 16 words.
+    const __m256i _Swap = _mm256_set_epi64x(
+        0x0C0D0E0F08090A0B, 0x0405060700010203, 0x0C0D0E0F08090A0B, 0x0405060700010203);
+    __m256i _Words[16];
+    for (size_t _Half = 0; _Half < 2; ++_Half) {
+        for (size_t _Lane = 0; _Lane < _SHA256_LANES; ++_Lane) {
+            _Words[_Half * 8 + _Lane] =
+                _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*) _Blocks[_Lane] + _Half), _Swap);
+        }
+
+        _Transpose_words_avx2(_Words + _Half * 8);
+    }
+
+    __m256i _A = _State[0];
+    __m256i _B = _State[1];
+    __m256i _C = _State[2];
+    __m256i _D = _State[3];
+    __m256i _E = _State[4];
+    __m256i _F = _State[5];
+    __m256i _G = _State[6];
+    __m256i _H = _State[7];
+    for (size_t _Idx = 0; _Idx < 64; ++_Idx) {
+        if (_Idx >= 16) {
+            const __m256i _Prev15 = _Words[(_Idx - 15) & 15];
+            const __m256i _Prev2  = _Words[(_Idx - 2) & 15];
+            const __m256i _Sigma0 = _Xor3_avx2(
+                _Rotr32_avx2(_Prev15, 7), _Rotr32_avx2(_Prev15, 18), _mm256_srli_epi32(_Prev15, 3));
+            const __m256i _Sigma1 = _Xor3_avx2(
+                _Rotr32_avx2(_Prev2, 17), _Rotr32_avx2(_Prev2, 19), _mm256_srli_epi32(_Prev2, 10));
+            _Words[_Idx & 15] = _mm256_add_epi32(_mm256_add_epi32(_Words[_Idx & 15], _Sigma0),
+                _mm256_add_epi32(_Words[(_Idx - 7) & 15], _Sigma1));
+        }
+
+        const __m256i _Sum1  = _Xor3_avx2(_Rotr32_avx2(_E, 6), _Rotr32_avx2(_E, 11), _Rotr32_avx2(_E, 25));
+        const __m256i _Ch    = _mm256_xor_si256(_mm256_and_si256(_E, _F), _mm256_andnot_si256(_E, _G));
+        const __m256i _Word  = _mm256_add_epi32(
+            _Words[_Idx & 15], _mm256_set1_epi32((int) _Sha256_constants[_Idx])); // with the round constant
+        const __m256i _Temp1 = _mm256_add_epi32(_mm256_add_epi32(_H, _Sum1), _mm256_add_epi32(_Ch, _Word));
+        const __m256i _Sum0  = _Xor3_avx2(_Rotr32_avx2(_A, 2), _Rotr32_avx2(_A, 13), _Rotr32_avx2(_A, 22));
+        const __m256i _Maj   = _mm256_xor_si256(
+            _mm256_and_si256(_mm256_xor_si256(_A, _B), _mm256_xor_si256(_B, _C)), _B);
+        _H = _G;
+        _G = _F;
+        _F = _E;
+        _E = _mm256_add_epi32(_D, _Temp1);
+        _D = _C;
+        _C = _B;
+        _B = _A;
+        _A = _mm256_add_epi32(_Temp1, _mm256_add_epi32(_Sum0, _Maj));
+    }
+
+    _State[0] = _mm256_add_epi32(_State[0], _A);
+    _State[1] = _mm256_add_epi32(_State[1], _B);
+    _State[2] = _mm256_add_epi32(_State[2], _C);
+    _State[3] = _mm256_add_epi32(_State[3], _D);
+    _State[4] = _mm256_add_epi32(_State[4], _E);
+    _State[5] = _mm256_add_epi32(_State[5], _F);
+    _State[6] = _mm256_add_epi32(_State[6], _G);
+    _State[7] = _mm256_add_epi32(_State[7], _H);
+}
+#endif // _SHA2_X86
+
+inline void _SCFG_CONV _Sha256_blocks(
+    uint32_t* const _Hash, const uint8_t* const _Data, const size_t _Count) {
+#if _SHA2_X86
+    if (_Get_sha256_kernel() == scfg_hash_kernel_sha_ni) {
+        _Sha256_blocks_sha_ni(_Hash, _Data, _Count);
+        return;
+    }
+#endif // _SHA2_X86
+
+    _Sha256_blocks_portable(_Hash, _Data, _Count);
+}
+
+inline void _SCFG_CONV _Sha512_blocks(
+    uint64_t* const _Hash, const uint8_t* const _Data, const size_t _Count) {
+#if _SHA2_X86
+    if (_Get_sha512_kernel() == scfg_hash_kernel_avx2) {
+        _Sha512_blocks_avx2(_Hash, _Data, _Count);
+        return;
+    }
+#endif // _SHA2_X86
+
+    _Sha512_blocks_portable(_Hash, _Data, _Count);
+}
+
+void _SCFG_CONV _Sha256_init(struct _Sha256_state* const _State) {
+    memcpy(_State->_Hash, _Sha256_initial_hash, sizeof(_Sha256_initial_hash));
+    _State->_Buffered = 0;
+    _State->_Total    = 0;
+}
+
+void _SCFG_CONV _Sha256_update(struct _Sha256_state* const _State, const uint8_t* _Data, size_t _Size) {
+    if (_Size == 0) {
+        return;
+    }
+
+    _State->_Total += _Size;
+    if (_State->_Buffered > 0) { // complete the buffered block first
+        const size_t _Fill = _Size < _SHA256_BLOCK_SIZE - _State->_Buffered
+                               ? _Size : _SHA256_BLOCK_SIZE - _State->_Buffered;
+        memcpy(_State->_Buffer + _State->_Buffered, _Data, _Fill);
+        _State->_Buffered += _Fill;
+        _Data += _Fill;
+        _Size -= _Fill;
+        if (_State->_Buffered < _SHA256_BLOCK_SIZE) {
+            return;
+        }
+
+        _Sha256_blocks(_State->_Hash, _State->_Buffer, 1);
+        _State->_Buffered = 0;
+    }
+
+    const size_t _Blocks = _Size / _SHA256_BLOCK_SIZE;
+    if (_Blocks > 0) { // whole blocks are hashed in place
+        _Sha256_blocks(_State->_Hash, _Data, _Blocks);
+        _Data += _Blocks * _SHA256_BLOCK_SIZE;
+        _Size -= _Blocks * _SHA256_BLOCK_SIZE;
+    }
+
+    memcpy(_State->_Buffer, _Data, _Size);
+    _State->_Buffered = _Size;
+}
+
+void _SCFG_CONV _Sha256_finalize(struct _Sha256_state* const _State, uint8_t* const _Out) {
+    // Note: The message is padded with 0x80, zeros and its length in bits, so the last block
+    //       ends with the 64-bit length. One extra block is needed if the length does not fit.
+    _State->_Buffer[_State->_Buffered++] = 0x80;
+    if (_State->_Buffered > _SHA256_BLOCK_SIZE - sizeof(uint64_t)) {
+        memset(_State->_Buffer + _State->_Buffered, 0, _SHA256_BLOCK_SIZE - _State->_Buffered);
+        _Sha256_blocks(_State->_Hash, _State->_Buffer, 1);
+        _State->_Buffered = 0;
+    }
+
+    memset(_State->_Buffer + _State->_Buffered, 0, _SHA256_BLOCK_SIZE - sizeof(uint64_t) - _State->_Buffered);
+    _Store_be64(_State->_Total << 3, _State->_Buffer + _SHA256_BLOCK_SIZE - sizeof(uint64_t));
+    _Sha256_blocks(_State->_Hash, _State->_Buffer, 1);
+    for (size_t _Idx = 0; _Idx < 8; ++_Idx) {
+        _Store_be32(_State->_Hash[_Idx], _Out + 4 * _Idx);
+    }
+}
+
+void _SCFG_CONV _Sha256(const uint8_t* const _Data, const size_t _Size, uint8_t* const _Out) {
+    struct _Sha256_state _State;
+    _Sha256_init(&_State);
+    _Sha256_update(&_State, _Data, _Size);
+    _Sha256_finalize(&_State, _Out);
+}
+
+#if _SHA2_X86
+struct _Sha256_lane { // a message hashed in one lane of the batch kernel
+    const uint8_t* _Data; // the next block
+    size_t _Blocks; // blocks left in _Data
+    size_t _Tail_blocks; // padded blocks in _Tail, 0 once _Data points to _Tail
+    size_t _Msg; // index of the message, SIZE_MAX if the lane is idle
+    uint8_t _Tail[2 * _SHA256_BLOCK_SIZE]; // the rest of the message, padded
+};
+
+inline void _SCFG_CONV _Load_sha256_lane(
+    struct _Sha256_lane* const _Lane, const uint8_t* const _Data, const size_t _Size, const size_t _Msg) {
+    // Note: The padding of _Sha256_finalize() is prepared up front, so the lane only ever
+    //       compresses whole blocks.
+    const size_t _Whole = _Size / _SHA256_BLOCK_SIZE;
+    const size_t _Rest  = _Size % _SHA256_BLOCK_SIZE;
+    _Lane->_Data        = _Data;
+    _Lane->_Blocks      = _Whole;
+    _Lane->_Tail_blocks = _Rest < _SHA256_BLOCK_SIZE - sizeof(uint64_t) ? 1 : 2;
+    _Lane->_Msg         = _Msg;
+    memset(_Lane->_Tail, 0, sizeof(_Lane->_Tail));
+    if (_Rest > 0) {
+        memcpy(_Lane->_Tail, _Data + _Whole * _SHA256_BLOCK_SIZE, _Rest);
+    }
+
+    _Lane->_Tail[_Rest] = 0x80;
+    uint8_t* const _Length = _Lane->_Tail + _Lane->_Tail_blocks * _SHA256_BLOCK_SIZE - sizeof(uint64_t);
+    _Store_be64((uint64_t) _Size << 3, _Length);
+    if (_Whole == 0) { // only the padded blocks are left
+        _Lane->_Data        = _Lane->_Tail;
+        _Lane->_Blocks      = _Lane->_Tail_blocks;
+        _Lane->_Tail_blocks = 0;
+    }
+}
+
+inline void _SCFG_CONV _Next_sha256_block(struct _Sha256_lane* const _Lane) {
+    // moves to the next block, _Blocks is 0 once the message is finished
+    _Lane->_Data += _SHA256_BLOCK_SIZE;
+    if (--_Lane->_Blocks == 0 && _Lane->_Tail_blocks > 0) {
+        _Lane->_Data        = _Lane->_Tail;
+        _Lane->_Blocks      = _Lane->_Tail_blocks;
+        _Lane->_Tail_blocks = 0;
+    }
+}
+
+inline void _SCFG_CONV _Sha256_many_avx2(
+    const uint8_t* const* const _Data, const size_t* const _Sizes, const size_t _Count, uint8_t* const _Out) {
+    // Note: A lane that finishes its message takes the next one, so messages of different lengths
+    //       keep every lane busy. The last message is finished by the single-message kernel.
+    static const uint8_t _Idle_block[_SHA256_BLOCK_SIZE] = {0}; // compressed by idle lanes
+    struct _Sha256_lane _Lanes[_SHA256_LANES];
+    uint32_t _Hash[8][_SHA256_LANES]; // word-major, like _State
+    __m256i _State[8];
+    const uint8_t* _Blocks[_SHA256_LANES];
+    size_t _Next   = 0; // the next message to be loaded
+    size_t _Active = 0; // lanes that have a message
+    for (size_t _Lane = 0; _Lane < _SHA256_LANES; ++_Lane) {
+        if (_Next < _Count) {
+            _Load_sha256_lane(&_Lanes[_Lane], _Data[_Next], _Sizes[_Next], _Next);
+            ++_Next;
+            ++_Active;
+        } else {
+            _Lanes[_Lane]._Msg = SIZE_MAX;
+        }
+    }
+
+    for (size_t _Word = 0; _Word < 8; ++_Word) {
+        _State[_Word] = _mm256_set1_epi32((int) _Sha256_initial_hash[_Word]);
+    }
+
+    while (_Active > 1) {
+        for (size_t _Lane = 0; _Lane < _SHA256_LANES; ++_Lane) {
+            _Blocks[_Lane] = _Lanes[_Lane]._Msg != SIZE_MAX ? _Lanes[_Lane]._Data : _Idle_block;
+        }
+
+        _Sha256_compress_avx2(_State, _Blocks);
+        int _Finished = 0;
+        for (size_t _Lane = 0; _Lane < _SHA256_LANES; ++_Lane) {
+            if (_Lanes[_Lane]._Msg != SIZE_MAX) {
+                _Next_sha256_block(&_Lanes[_Lane]);
+                _Finished |= _Lanes[_Lane]._Blocks == 0;
+            }
+        }
+
+        if (!_Finished) {
+            continue;
+        }
+
+        for (size_t _Word = 0; _Word < 8; ++_Word) {
+            _mm256_storeu_si256((__m256i*) _Hash[_Word], _State[_Word]);
+        }
+
+        for (size_t _Lane = 0; _Lane < _SHA256_LANES; ++_Lane) {
+            struct _Sha256_lane* const _Ptr = &_Lanes[_Lane];
+            if (_Ptr->_Msg == SIZE_MAX || _Ptr->_Blocks > 0) { // idle or not finished
+                continue;
+            }
+
+            for (size_t _Word = 0; _Word < 8; ++_Word) {
+                _Store_be32(_Hash[_Word][_Lane], _Out + _Ptr->_Msg * 32 + 4 * _Word);
+                _Hash[_Word][_Lane] = _Sha256_initial_hash[_Word];
+            }
+
+            if (_Next < _Count) {
+                _Load_sha256_lane(_Ptr, _Data[_Next], _Sizes[_Next], _Next);
+                ++_Next;
+            } else {
+                _Ptr->_Msg = SIZE_MAX;
+                --_Active;
+            }
+        }
+
+        for (size_t _Word = 0; _Word < 8; ++_Word) {
+            _State[_Word] = _mm256_loadu_si256((const __m256i*) _Hash[_Word]);
+        }
+    }
+
+    if (_Active == 0) {
+        return;
+    }
+
+    for (size_t _Word = 0; _Word < 8; ++_Word) {
+        _mm256_storeu_si256((__m256i*) _Hash[_Word], _State[_Word]);
+    }
+
+    for (size_t _Lane = 0; _Lane < _SHA256_LANES; ++_Lane) { // the last message
+        struct _Sha256_lane* const _Ptr = &_Lanes[_Lane];
+        if (_Ptr->_Msg == SIZE_MAX) {
+            continue;
+        }
+
+        uint32_t _Last[8];
+        for (size_t _Word = 0; _Word < 8; ++_Word) {
+            _Last[_Word] = _Hash[_Word][_Lane];
+        }
+
+        _Sha256_blocks(_Last, _Ptr->_Data, _Ptr->_Blocks);
+        if (_Ptr->_Tail_blocks > 0) {
+            _Sha256_blocks(_Last, _Ptr->_Tail, _Ptr->_Tail_blocks);
+        }
+
+        for (size_t _Word = 0; _Word < 8; ++_Word) {
+            _Store_be32(_Last[_Word], _Out + _Ptr->_Msg * 32 + 4 * _Word);
+        }
+    }
+}
+#endif // _SHA2_X86
+
+void _SCFG_CONV _Sha256_many(
+    const uint8_t* const* const _Data, const size_t* const _Sizes, const size_t _Count, uint8_t* const _Out) {
+#if _SHA2_X86
+    if (_Count > 1 && _Get_sha256_batch_kernel() == scfg_hash_kernel_avx2) {
+        _Sha256_many_avx2(_Data, _Sizes, _Count, _Out);
+        return;
+    }
+#endif // _SHA2_X86
+
+    for (size_t _Idx = 0; _Idx < _Count; ++_Idx) {
+        _Sha256(_Data[_Idx], _Sizes[_Idx], _Out + _Idx * 32);
+    }
+}
+
+void _SCFG_CONV _Sha512_init(struct _Sha512_state* const _State) {
+    static const uint64_t _Initial_hash[8] = {0x6A09E667F3BCC908, 0xBB67AE8584CAA73B, 0x3C6EF372FE94F82B,
+        0xA54FF53A5F1D36F1, 0x510E527FADE682D1, 0x9B05688C2B3E6C1F, 0x1F83D9ABFB41BD6B, 0x5BE0CD19137E2179};
+    memcpy(_State->_Hash, _Initial_hash, sizeof(_Initial_hash));
+    _State->_Buffered = 0;
+    _State->_Total    = 0;
+}
+
+void _SCFG_CONV _Sha512_update(struct _Sha512_state* const _State, const uint8_t* _Data, size_t _Size) {
+    if (_Size == 0) {
+        return;
+    }
+
+    _State->_Total += _Size;
+    if (_State->_Buffered > 0) {
+        const size_t _Fill = _Size < _SHA512_BLOCK_SIZE - _State->_Buffered
+                               ? _Size : _SHA512_BLOCK_SIZE - _State->_Buffered;
+        memcpy(_State->_Buffer + _State->_Buffered, _Data, _Fill);
+        _State->_Buffered += _Fill;
+        _Data += _Fill;
+        _Size -= _Fill;
+        if (_State->_Buffered < _SHA512_BLOCK_SIZE) {
+            return;
+        }
+
+        _Sha512_blocks(_State->_Hash, _State->_Buffer, 1);
+        _State->_Buffered = 0;
+    }
+
+    const size_t _Blocks = _Size / _SHA512_BLOCK_SIZE;
+    if (_Blocks > 0) {
+        _Sha512_blocks(_State->_Hash, _Data, _Blocks);
+        _Data += _Blocks * _SHA512_BLOCK_SIZE;
+        _Size -= _Blocks * _SHA512_BLOCK_SIZE;
+    }
+
+    memcpy(_State->_Buffer, _Data, _Size);
+    _State->_Buffered = _Size;
+}
+
+void _SCFG_CONV _Sha512_finalize(struct _Sha512_state* const _State, uint8_t* const _Out) {
+    // Note: SHA-512 stores a 128-bit length, its upper half holds the bits shifted out of _Total.
+    _State->_Buffer[_State->_Buffered++] = 0x80;
+    if (_State->_Buffered > _SHA512_BLOCK_SIZE - 2 * sizeof(uint64_t)) {
+        memset(_State->_Buffer + _State->_Buffered, 0, _SHA512_BLOCK_SIZE - _State->_Buffered);
+        _Sha512_blocks(_State->_Hash, _State->_Buffer, 1);
+        _State->_Buffered = 0;
+    }
+
+    memset(_State->_Buffer + _State->_Buffered, 0, _SHA512_BLOCK_SIZE - sizeof(uint64_t) - _State->_Buffered);
+    _Store_be64(_State->_Total >> 61, _State->_Buffer + _SHA512_BLOCK_SIZE - 2 * sizeof(uint64_t));
+    _Store_be64(_State->_Total << 3, _State->_Buffer + _SHA512_BLOCK_SIZE - sizeof(uint64_t));
+    _Sha512_blocks(_State->_Hash, _State->_Buffer, 1);
+    for (size_t _Idx = 0; _Idx < 8; ++_Idx) {
+        _Store_be64(_State->_Hash[_Idx], _Out + 8 * _Idx);
+    }
+}
+
+void _SCFG_CONV _Sha512(const uint8_t* const _Data, const size_t _Size, uint8_t* const _Out) {
+    struct _Sha512_state _State;
+    _Sha512_init(&_State);
+    _Sha512_update(&_State, _Data, _Size);
+    _Sha512_finalize(&_State, _Out);
+}
\ No newline at end of file
@@ -0,0 +1,301 @@
+// sha3.c
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <inc/scfg.h>
+#include <intrin.h>
+#include <scfgpch.h>
+#include <sha3.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#if defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#define _SHA3_X86 1 // the AVX2 kernel is selected with CPUID
+#else // ^^^ x86 ^^^ / vvv !x86 vvv
+#define _SHA3_X86 0
+#endif // x86
+
+#define _SHA3_512_RATE 72 // bytes absorbed per permutation, the capacity is twice the hash size
+#define _SHA3_512_SIZE 64
+#define _SHA3_LANES    4 // messages hashed at once by _Sha3_512_batch()
+
+#if _SHA3_X86
+static const uint64_t _Keccak_round_constants[24] = {0x0000000000000001, 0x0000000000008082,
+    0x800000000000808A, 0x8000000080008000, 0x000000000000808B, 0x0000000080000001, 0x8000000080008081,
+    0x8000000000008009, 0x000000000000008A, 0x0000000000000088, 0x0000000080008009, 0x000000008000000A,
+    0x000000008000808B, 0x800000000000008B, 0x8000000000008089, 0x8000000000008003, 0x8000000000008002,
+    0x8000000000000080, 0x000000000000800A, 0x800000008000000A, 0x8000000080008081, 0x8000000000008080,
+    0x0000000080000001, 0x8000000080008008};
+
+static int _Sha3_avx2            = 0; // the processor and the operating system support AVX2
+static INIT_ONCE _Sha3_avx2_once = INIT_ONCE_STATIC_INIT;
+
+static BOOL CALLBACK _Detect_sha3_avx2(INIT_ONCE* const _Once, void* const _Param, void** const _Ctx) {
+    (void) _Once;
+    (void) _Param;
+    (void) _Ctx;
+    int _Info[4];
+    __cpuid(_Info, 0);
+    if (_Info[0] < 7) { // no extended features
+        return TRUE;
+    }
+
+    __cpuid(_Info, 1);
+    const int _Features = _Info[2];
+    __cpuidex(_Info, 7, 0);
+    const int _Extended_features = _Info[1];
+
+    // Note: AVX2 also requires the operating system to save the YMM registers (OSXSAVE and XCR0).
+    if ((_Extended_features & (1 << 5)) && (_Features & (1 << 27)) && (_Features & (1 << 28))
+        && (_xgetbv(0) & 0x6) == 0x6) {
+        _Sha3_avx2 = 1;
+    }
+
+    return TRUE;
+}
+
+inline uint64_t _SCFG_CONV _Load_le64(const uint8_t* const _Ptr) {
+    uint64_t _Val;
+    memcpy(&_Val, _Ptr, sizeof(uint64_t)); // Windows is always little-endian
+    return _Val;
+}
+
+inline __m256i _SCFG_CONV _Rotl64_avx2(const __m256i _Val, const int _Shift) {
+    // AVX2 has no 64-bit rotation, a shift by 64 yields 0, so a rotation by 0 is still correct
+    return _mm256_or_si256(_mm256_slli_epi64(_Val, _Shift), _mm256_srli_epi64(_Val, 64 - _Shift));
+}
+
+inline __m256i _SCFG_CONV _Xor5_avx2(const __m256i _First, const __m256i _Second, const __m256i _Third,
+    const __m256i _Fourth, const __m256i _Fifth) {
+    return _mm256_xor_si256(
+        _mm256_xor_si256(_mm256_xor_si256(_First, _Second), _mm256_xor_si256(_Third, _Fourth)), _Fifth);
+}
+
+inline __m256i _SCFG_CONV _Chi_avx2(const __m256i _Word, const __m256i _Next, const __m256i _After_next) {
+    return _mm256_xor_si256(_Word, _mm256_andnot_si256(_Next, _After_next));
+}
+
+inline void _SCFG_CONV _Keccak_permute_avx2(__m256i* const _State) {
+    // Note: Each vector holds the same word of four states, so every lane permutes the state of its own
+    //       message. The state is indexed by x + 5 * y. Theta is folded into rho and pi, which rotate
+    //       every word and move it to its new position, and chi then combines the words of each row.
+    for (size_t _Round = 0; _Round < 24; ++_Round) {
+        const __m256i _C0 = _Xor5_avx2(_State[0], _State[5], _State[10], _State[15], _State[20]);
+        const __m256i _C1 = _Xor5_avx2(_State[1], _State[6], _State[11], _State[16], _State[21]);
+        const __m256i _C2 = _Xor5_avx2(_State[2], _State[7], _State[12], _State[17], _State[22]);
+        const __m256i _C3 = _Xor5_avx2(_State[3], _State[8], _State[13], _State[18], _State[23]);
+        const __m256i _C4 = _Xor5_avx2(_State[4], _State[9], _State[14], _State[19], _State[24]);
+        const __m256i _D0 = _mm256_xor_si256(_C4, _Rotl64_avx2(_C1, 1));
+        const __m256i _D1 = _mm256_xor_si256(_C0, _Rotl64_avx2(_C2, 1));
+        const __m256i _D2 = _mm256_xor_si256(_C1, _Rotl64_avx2(_C3, 1));
+        const __m256i _D3 = _mm256_xor_si256(_C2, _Rotl64_avx2(_C4, 1));
+        const __m256i _D4 = _mm256_xor_si256(_C3, _Rotl64_avx2(_C0, 1));
+        const __m256i _B0  = _mm256_xor_si256(_State[0], _D0);
+        const __m256i _B1  = _Rotl64_avx2(_mm256_xor_si256(_State[6], _D1), 44);
+        const __m256i _B2  = _Rotl64_avx2(_mm256_xor_si256(_State[12], _D2), 43);
+        const __m256i _B3  = _Rotl64_avx2(_mm256_xor_si256(_State[18], _D3), 21);
+        const __m256i _B4  = _Rotl64_avx2(_mm256_xor_si256(_State[24], _D4), 14);
+        const __m256i _B5  = _Rotl64_avx2(_mm256_xor_si256(_State[3], _D3), 28);
+        const __m256i _B6  = _Rotl64_avx2(_mm256_xor_si256(_State[9], _D4), 20);
+        const __m256i _B7  = _Rotl64_avx2(_mm256_xor_si256(_State[10], _D0), 3);
+        const __m256i _B8  = _Rotl64_avx2(_mm256_xor_si256(_State[16], _D1), 45);
+        const __m256i _B9  = _Rotl64_avx2(_mm256_xor_si256(_State[22], _D2), 61);
+        const __m256i _B10 = _Rotl64_avx2(_mm256_xor_si256(_State[1], _D1), 1);
+        const __m256i _B11 = _Rotl64_avx2(_mm256_xor_si256(_State[7], _D2), 6);
+        const __m256i _B12 = _Rotl64_avx2(_mm256_xor_si256(_State[13], _D3), 25);
+        const __m256i _B13 = _Rotl64_avx2(_mm256_xor_si256(_State[19], _D4), 8);
+        const __m256i _B14 = _Rotl64_avx2(_mm256_xor_si256(_State[20], _D0), 18);
+        const __m256i _B15 = _Rotl64_avx2(_mm256_xor_si256(_State[4], _D4), 27);
+        const __m256i _B16 = _Rotl64_avx2(_mm256_xor_si256(_State[5], _D0), 36);
+        const __m256i _B17 = _Rotl64_avx2(_mm256_xor_si256(_State[11], _D1), 10);
+        const __m256i _B18 = _Rotl64_avx2(_mm256_xor_si256(_State[17], _D2), 15);
+        const __m256i _B19 = _Rotl64_avx2(_mm256_xor_si256(_State[23], _D3), 56);
+        const __m256i _B20 = _Rotl64_avx2(_mm256_xor_si256(_State[2], _D2), 62);
+        const __m256i _B21 = _Rotl64_avx2(_mm256_xor_si256(_State[8], _D3), 55);
+        const __m256i _B22 = _Rotl64_avx2(_mm256_xor_si256(_State[14], _D4), 39);
+        const __m256i _B23 = _Rotl64_avx2(_mm256_xor_si256(_State[15], _D0), 41);
+        const __m256i _B24 = _Rotl64_avx2(_mm256_xor_si256(_State[21], _D1), 2);
+        _State[0]  = _Chi_avx2(_B0, _B1, _B2);
+        _State[1]  = _Chi_avx2(_B1, _B2, _B3);
+        _State[2]  = _Chi_avx2(_B2, _B3, _B4);
+        _State[3]  = _Chi_avx2(_B3, _B4, _B0);
+        _State[4]  = _Chi_avx2(_B4, _B0, _B1);
+        _State[5]  = _Chi_avx2(_B5, _B6, _B7);
+        _State[6]  = _Chi_avx2(_B6, _B7, _B8);
+        _State[7]  = _Chi_avx2(_B7, _B8, _B9);
+        _State[8]  = _Chi_avx2(_B8, _B9, _B5);
+        _State[9]  = _Chi_avx2(_B9, _B5, _B6);
+        _State[10] = _Chi_avx2(_B10, _B11, _B12);
+        _State[11] = _Chi_avx2(_B11, _B12, _B13);
+        _State[12] = _Chi_avx2(_B12, _B13, _B14);
+        _State[13] = _Chi_avx2(_B13, _B14, _B10);
+        _State[14] = _Chi_avx2(_B14, _B10, _B11);
+        _State[15] = _Chi_avx2(_B15, _B16, _B17);
+        _State[16] = _Chi_avx2(_B16, _B17, _B18);
+        _State[17] = _Chi_avx2(_B17, _B18, _B19);
+        _State[18] = _Chi_avx2(_B18, _B19, _B15);
+        _State[19] = _Chi_avx2(_B19, _B15, _B16);
+        _State[20] = _Chi_avx2(_B20, _B21, _B22);
+        _State[21] = _Chi_avx2(_B21, _B22, _B23);
+        _State[22] = _Chi_avx2(_B22, _B23, _B24);
+        _State[23] = _Chi_avx2(_B23, _B24, _B20);
+        _State[24] = _Chi_avx2(_B24, _B20, _B21);
+        _State[0] = _mm256_xor_si256( // iota
+            _State[0], _mm256_set1_epi64x((long long) _Keccak_round_constants[_Round]));
+    }
+}
+
+inline void _SCFG_CONV _Keccak_absorb_avx2(__m256i* const _State, const uint8_t* const* const _Blocks) {
+    for (size_t _Word = 0; _Word < _SHA3_512_RATE / sizeof(uint64_t); ++_Word) {
+        const size_t _Off = _Word * sizeof(uint64_t);
+        const __m256i _Val = _mm256_set_epi64x((long long) _Load_le64(_Blocks[3] + _Off),
+            (long long) _Load_le64(_Blocks[2] + _Off), (long long) _Load_le64(_Blocks[1] + _Off),
+            (long long) _Load_le64(_Blocks[0] + _Off));
+        _State[_Word] = _mm256_xor_si256(_State[_Word], _Val);
+    }
+
+    _Keccak_permute_avx2(_State);
+}
+
+struct _Sha3_lane { // a message hashed in one lane of the batch kernel
+    const uint8_t* _Data; // the next block
+    size_t _Blocks; // blocks left in _Data
+    size_t _Tail_blocks; // padded blocks in _Tail, 0 once _Data points to _Tail
+    size_t _Msg; // index of the message, SIZE_MAX if the lane is idle
+    uint8_t _Tail[_SHA3_512_RATE]; // the rest of the message, padded
+};
+
+inline void _SCFG_CONV _Load_sha3_lane(
+    struct _Sha3_lane* const _Lane, const uint8_t* const _Data, const size_t _Size, const size_t _Msg) {
+    // Note: The SHA3 padding always fits in one block, because the domain bits and the final bit
+    //       may share a byte.
+    const size_t _Whole = _Size / _SHA3_512_RATE;
+    const size_t _Rest  = _Size % _SHA3_512_RATE;
+    _Lane->_Data        = _Data;
+    _Lane->_Blocks      = _Whole;
+    _Lane->_Tail_blocks = 1;
+    _Lane->_Msg         = _Msg;
+    memset(_Lane->_Tail, 0, sizeof(_Lane->_Tail));
+    if (_Rest > 0) {
+        memcpy(_Lane->_Tail, _Data + _Whole * _SHA3_512_RATE, _Rest);
+    }
+
+    _Lane->_Tail[_Rest] = 0x06; // the SHA3 domain bits and the first padding bit
+    _Lane->_Tail[_SHA3_512_RATE - 1] |= 0x80;
+    if (_Whole == 0) { // only the padded block is left
+        _Lane->_Data        = _Lane->_Tail;
+        _Lane->_Blocks      = 1;
+        _Lane->_Tail_blocks = 0;
+    }
+}
+
+inline void _SCFG_CONV _Next_sha3_block(struct _Sha3_lane* const _Lane) {
+    // moves to the next block, _Blocks is 0 once the message is finished
+    _Lane->_Data += _SHA3_512_RATE;
+    if (--_Lane->_Blocks == 0 && _Lane->_Tail_blocks > 0) {
+        _Lane->_Data        = _Lane->_Tail;
+        _Lane->_Blocks      = _Lane->_Tail_blocks;
+        _Lane->_Tail_blocks = 0;
+    }
+}
+
+inline void _SCFG_CONV _Load_next_sha3_message(struct _Sha3_lane* const _Lane,
+    const uint8_t* const* const _Data, const size_t* const _Sizes, const size_t _Count, size_t* const _Next) {
+    // loads the next message that is short enough, or marks the lane as idle
+    for (; *_Next < _Count; ++*_Next) {
+        if (_Sizes[*_Next] <= _SHA3_BATCH_MAX_SIZE) {
+            _Load_sha3_lane(_Lane, _Data[*_Next], _Sizes[*_Next], *_Next);
+            ++*_Next;
+            return;
+        }
+    }
+
+    _Lane->_Msg = SIZE_MAX;
+}
+
+inline void _SCFG_CONV _Sha3_512_many_avx2(
+    const uint8_t* const* const _Data, const size_t* const _Sizes, const size_t _Count, uint8_t* const _Out) {
+    // Note: A lane that finishes its message takes the next one, so messages of different lengths
+    //       keep every lane busy. Idle lanes absorb a block of zeros until the batch is finished.
+    static const uint8_t _Idle_block[_SHA3_512_RATE] = {0};
+    struct _Sha3_lane _Lanes[_SHA3_LANES];
+    uint64_t _Words[25][_SHA3_LANES]; // word-major, like _State
+    __m256i _State[25];
+    const uint8_t* _Blocks[_SHA3_LANES];
+    size_t _Next   = 0; // the next message to be loaded
+    size_t _Active = 0; // lanes that have a message
+    for (size_t _Lane = 0; _Lane < _SHA3_LANES; ++_Lane) {
+        _Load_next_sha3_message(&_Lanes[_Lane], _Data, _Sizes, _Count, &_Next);
+        _Active += _Lanes[_Lane]._Msg != SIZE_MAX;
+    }
+
+    for (size_t _Word = 0; _Word < 25; ++_Word) {
+        _State[_Word] = _mm256_setzero_si256();
+    }
+
+    while (_Active > 0) {
+        for (size_t _Lane = 0; _Lane < _SHA3_LANES; ++_Lane) {
+            _Blocks[_Lane] = _Lanes[_Lane]._Msg != SIZE_MAX ? _Lanes[_Lane]._Data : _Idle_block;
+        }
+
+        _Keccak_absorb_avx2(_State, _Blocks);
+        int _Finished = 0;
+        for (size_t _Lane = 0; _Lane < _SHA3_LANES; ++_Lane) {
+            if (_Lanes[_Lane]._Msg != SIZE_MAX) {
+                _Next_sha3_block(&_Lanes[_Lane]);
+                _Finished |= _Lanes[_Lane]._Blocks == 0;
+            }
+        }
+
+        if (!_Finished) {
+            continue;
+        }
+
+        for (size_t _Word = 0; _Word < 25; ++_Word) {
+            _mm256_storeu_si256((__m256i*) _Words[_Word], _State[_Word]);
+        }
+
+        for (size_t _Lane = 0; _Lane < _SHA3_LANES; ++_Lane) {
+            struct _Sha3_lane* const _Ptr = &_Lanes[_Lane];
+            if (_Ptr->_Msg == SIZE_MAX || _Ptr->_Blocks > 0) { // idle or not finished
+                continue;
+            }
+
+            for (size_t _Word = 0; _Word < _SHA3_512_SIZE / sizeof(uint64_t); ++_Word) { // little-endian
+                memcpy(_Out + _Ptr->_Msg * _SHA3_512_SIZE + _Word * sizeof(uint64_t), &_Words[_Word][_Lane],
+                    sizeof(uint64_t));
+            }
+
+            for (size_t _Word = 0; _Word < 25; ++_Word) {
+                _Words[_Word][_Lane] = 0;
+            }
+
+            _Load_next_sha3_message(_Ptr, _Data, _Sizes, _Count, &_Next);
+            _Active -= _Ptr->_Msg == SIZE_MAX;
+        }
+
+        for (size_t _Word = 0; _Word < 25; ++_Word) {
+            _State[_Word] = _mm256_loadu_si256((const __m256i*) _Words[_Word]);
+        }
+    }
+}
+#endif // _SHA3_X86
+
+int _SCFG_CONV _Sha3_512_batch(
+    const uint8_t* const* const _Data, const size_t* const _Sizes, const size_t _Count, uint8_t* const _Out) {
+#if _SHA3_X86
+    InitOnceExecuteOnce(&_Sha3_avx2_once, _Detect_sha3_avx2, NULL, NULL); // cannot fail
+    if (_Count > 1 && _Sha3_avx2) {
+        _Sha3_512_many_avx2(_Data, _Sizes, _Count, _Out);
+        return 1;
+    }
+#else // ^^^ _SHA3_X86 ^^^ / vvv !_SHA3_X86 vvv
+    (void) _Data;
+    (void) _Sizes;
+    (void) _Count;
+    (void) _Out;
+#endif // _SHA3_X86
+    return 0;
+}
\ No newline at end of file
@@ -6,6 +6,71 @@
 #include <inc/scfg.h>
 #include <scfgpch.h>
 #include <stdlib.h>
+#include <unicode.h>
+
+scfg_error_t _SCFG_CONV _Unicode_to_utf8(
+    const wchar_t* _Data, size_t _Size, char* _Ptr, size_t* const _Written) {
+    // Note: The caller must ensure that _Ptr is large enough to store the converted data.
+    char* const _First = _Ptr;
+    while (_Size-- > 0) {
+        if (*_Data <= 0x7F) { // 1 byte per word
+            *(_Ptr++) = (char)*_Data; // no leading byte
+        } else if (*_Data <= 0x07FF) { // 2 bytes per word
+            *(_Ptr++) = (char) (((*_Data >> 6) & 0x1F) | 0xC0); // leading byte
+            *(_Ptr++) = (char) ((*_Data & 0x3F) | 0x80);
+        } else if (*_Data <= 0xFFFF) { // 3 bytes per word
+            *(_Ptr++) = (char) (((*_Data >> 12) & 0x0F) | 0xE0); // leading byte
+            *(_Ptr++) = (char) (((*_Data >> 6) & 0x3F) | 0x80);
+            *(_Ptr++) = (char) ((*_Data & 0x3F) | 0x80);
+        } else if (*_Data <= 0x0010'FFFF) { // 4 bytes per word
+            *(_Ptr++) = (char) (((*_Data >> 18) & 0x07) | 0xF0); // leading byte
+            *(_Ptr++) = (char) (((*_Data >> 12) & 0x3F) | 0x80);
+            *(_Ptr++) = (char) (((*_Data >> 6) & 0x3F) | 0x80);
+            *(_Ptr++) = (char) ((*_Data & 0x3F) | 0x80);
+        } else { // word too large, see RFC 3629
+            return scfg_error_code_point_too_large;
+        }
+
+        ++_Data;
+    }
+
+    if (_Written) { // store the number of converted bytes
+        *_Written = (size_t) (_Ptr - _First);
+    }
+
+    return scfg_error_success;
+}
+
+inline scfg_error_t _SCFG_CONV _Utf8_to_unicode(const char* _Data, size_t _Size, wchar_t* _Ptr) {
+    // Note: The caller must ensure that _Ptr is large enough to store the converted data.
+    while (_Size > 0) {
+        if ((*_Data & 0x80) == 0) { // 1 byte per word
+            *_Ptr = (wchar_t) *(_Data++);
+            --_Size;
+        } else if ((*_Data & 0xE0) == 0xC0) { // 2 bytes per word
+            *_Ptr  = (wchar_t) ((*(_Data++) & 0x1F) << 6);
+            *_Ptr |= (wchar_t) (*(_Data++) & 0x3F);
+            _Size -= 2;
+        } else if ((*_Data & 0xF0) == 0xE0) { // 3 bytes per word
+            *_Ptr  = (wchar_t) ((*(_Data++) & 0x0F) << 12);
+            *_Ptr |= (wchar_t) ((*(_Data++) & 0x3F) << 6);
+            *_Ptr |= (wchar_t) (*(_Data++) & 0x3F);
+            _Size -= 3;
+        } else if ((*_Data & 0xF8) == 0xF0) { // 4 bytes per word
+            *_Ptr  = (wchar_t) ((*(_Data++) & 0x07) << 18);
+            *_Ptr |= (wchar_t) ((*(_Data++) & 0x3F) << 12);
+            *_Ptr |= (wchar_t) ((*(_Data++) & 0x3F) << 6);
+            *_Ptr |= (wchar_t) (*(_Data++) & 0x3F);
+            _Size -= 4;
+        } else { // word too large, see RFC 3629
+            return scfg_error_code_point_too_large;
+        }
+
+        ++_Ptr;
+    }
+
+    return scfg_error_success;
+}
 
 scfg_error_t _SCFG_CONV scfg_unicode_to_utf8_required_buffer_size(
     const wchar_t* _Data, size_t _Data_size, size_t* const _Buf_size) {
@@ -85,29 +150,7 @@ scfg_error_t _SCFG_CONV scfg_unicode_to_utf8(
         return _Err;
     }
 
-    while (_Size-- > 0) {
-        if (*_Data <= 0x7F) { // 1 byte per word
-            *(_Ptr++) = (char)*_Data; // no leading byte
-        } else if (*_Data <= 0x07FF) { // 2 bytes per word
-            *(_Ptr++) = (char) (((*_Data >> 6) & 0x1F) | 0xC0); // leading byte
-            *(_Ptr++) = (char) ((*_Data & 0x3F) | 0x80);
-        } else if (*_Data <= 0xFFFF) { // 3 bytes per word
-            *(_Ptr++) = (char) (((*_Data >> 12) & 0x0F) | 0xE0); // leading byte
-            *(_Ptr++) = (char) (((*_Data >> 6) & 0x3F) | 0x80);
-            *(_Ptr++) = (char) ((*_Data & 0x3F) | 0x80);
-        } else if (*_Data <= 0x0010'FFFF) { // 4 bytes per word
-            *(_Ptr++) = (char) (((*_Data >> 18) & 0x07) | 0xF0); // leading byte
-            *(_Ptr++) = (char) (((*_Data >> 12) & 0x3F) | 0x80);
-            *(_Ptr++) = (char) (((*_Data >> 6) & 0x3F) | 0x80);
-            *(_Ptr++) = (char) ((*_Data & 0x3F) | 0x80);
-        } else { // word too large, see RFC 3629
-            return scfg_error_code_point_too_large;
-        }
-
-        ++_Data;
-    }
-
-    return scfg_error_success;
+    return _Unicode_to_utf8(_Data, _Size, _Ptr, NULL);
 }
 
 scfg_error_t _SCFG_CONV scfg_utf8_to_unicode(
@@ -132,31 +175,55 @@ scfg_error_t _SCFG_CONV scfg_utf8_to_unicode(
         return _Err;
     }
 
-    while (_Size > 0) {
-        if ((*_Data & 0x80) == 0) { // 1 byte per word
-            *_Ptr = (wchar_t) *(_Data++);
-            --_Size;
-        } else if ((*_Data & 0xE0) == 0xC0) { // 2 bytes per word
-            *_Ptr  = (wchar_t) ((*(_Data++) & 0x1F) << 6);
-            *_Ptr |= (wchar_t) (*(_Data++) & 0x3F);
-            _Size -= 2;
-        } else if ((*_Data & 0xF0) == 0xE0) { // 3 bytes per word
-            *_Ptr  = (wchar_t) ((*(_Data++) & 0x0F) << 12);
-            *_Ptr |= (wchar_t) ((*(_Data++) & 0x3F) << 6);
-            *_Ptr |= (wchar_t) (*(_Data++) & 0x3F);
-            _Size -= 3;
-        } else if ((*_Data & 0xF8) == 0xF0) { // 4 bytes per word
-            *_Ptr  = (wchar_t) ((*(_Data++) & 0x07) << 18);
-            *_Ptr |= (wchar_t) ((*(_Data++) & 0x3F) << 12);
-            *_Ptr |= (wchar_t) ((*(_Data++) & 0x3F) << 6);
-            *_Ptr |= (wchar_t) (*(_Data++) & 0x3F);
-            _Size -= 4;
-        } else { // word too large, see RFC 3629
-            return scfg_error_code_point_too_large;
-        }
+    return _Utf8_to_unicode(_Data, _Size, _Ptr);
+}
 
-        ++_Ptr;
+scfg_error_t _SCFG_CONV scfg_unicode_view_to_utf8(const scfg_unicode_view_t _Data, char* const _Out,
+    const size_t _Out_size, scfg_utf8_view_t* const _Result) {
+    if (!_Out) {
+        return scfg_error_invalid_buffer;
     }
 
-    return scfg_error_success;
+    size_t _Buf_size  = 0;
+    scfg_error_t _Err = scfg_unicode_to_utf8_required_buffer_size(_Data.data, _Data.size, &_Buf_size);
+    if (_Err != scfg_error_success) {
+        return _Err;
+    }
+
+    if (_Out_size < _Buf_size) {
+        return scfg_error_buffer_too_small;
+    }
+
+    _Err = _Unicode_to_utf8(_Data.data, _Data.size, _Out, NULL);
+    if (_Err == scfg_error_success && _Result) { // refer to the converted data
+        _Result->data = _Out;
+        _Result->size = _Buf_size;
+    }
+
+    return _Err;
+}
+
+scfg_error_t _SCFG_CONV scfg_utf8_view_to_unicode(const scfg_utf8_view_t _Data, wchar_t* const _Out,
+    const size_t _Out_size, scfg_unicode_view_t* const _Result) {
+    if (!_Out) {
+        return scfg_error_invalid_buffer;
+    }
+
+    size_t _Buf_size  = 0;
+    scfg_error_t _Err = scfg_utf8_to_unicode_required_buffer_size(_Data.data, _Data.size, &_Buf_size);
+    if (_Err != scfg_error_success) {
+        return _Err;
+    }
+
+    if (_Out_size < _Buf_size) {
+        return scfg_error_buffer_too_small;
+    }
+
+    _Err = _Utf8_to_unicode(_Data.data, _Data.size, _Out);
+    if (_Err == scfg_error_success && _Result) { // refer to the converted data
+        _Result->data = _Out;
+        _Result->size = _Buf_size;
+    }
+
+    return _Err;
 }
\ No newline at end of file
@@ -0,0 +1,504 @@
+// xxh3.c
+
+// Copyright (c) Mateusz Jandura. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <inc/scfg.h>
+#include <intrin.h>
+#include <scfgpch.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <xxh3.h>
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define _XXH3_SSE2 1 // SSE2 is part of every x64 processor
+#else // ^^^ SSE2 ^^^ / vvv !SSE2 vvv
+#define _XXH3_SSE2 0
+#endif // SSE2
+
+// Note: This is XXH3 from xxHash 0.8 with the default secret and a seed of 0. Hashes are
+//       stored in the canonical (big-endian) form, the 128-bit hash starts with its high half.
+#define _XXH_PRIME32_1 0x9E3779B1U
+#define _XXH_PRIME32_2 0x85EBCA77U
+#define _XXH_PRIME32_3 0xC2B2AE3DU
+#define _XXH_PRIME64_1 0x9E3779B185EBCA87ULL
+#define _XXH_PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define _XXH_PRIME64_3 0x165667B19E3779F9ULL
+#define _XXH_PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define _XXH_PRIME64_5 0x27D4EB2F165667C5ULL
+#define _XXH_PRIME_MX1 0x165667919E3779F9ULL
+#define _XXH_PRIME_MX2 0x9FB21C651E98DF25ULL
+
+#define _XXH3_STRIPE_SIZE       64
+#define _XXH3_SECRET_SIZE       192
+#define _XXH3_SECRET_SIZE_MIN   136
+#define _XXH3_SECRET_LIMIT      (_XXH3_SECRET_SIZE - _XXH3_STRIPE_SIZE)
+#define _XXH3_SECRET_RATE       8 // secret bytes consumed by each stripe
+#define _XXH3_BLOCK_STRIPES     (_XXH3_SECRET_LIMIT / _XXH3_SECRET_RATE)
+#define _XXH3_BLOCK_SIZE        (_XXH3_BLOCK_STRIPES * _XXH3_STRIPE_SIZE)
+#define _XXH3_MIDSIZE_MAX       240
+#define _XXH3_MIDSIZE_START     3
+#define _XXH3_MIDSIZE_LAST      17
+#define _XXH3_LAST_STRIPE_START 7
+#define _XXH3_MERGE_START       11
+
+static const uint8_t _Xxh3_secret[_XXH3_SECRET_SIZE] = {
+    0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+    0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+    0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+    0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+    0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+    0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+    0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+    0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+    0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+    0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+    0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+    0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e};
+
+struct _Xxh3_hash128 {
+    uint64_t _Low;
+    uint64_t _High;
+};
+
+inline uint32_t _SCFG_CONV _Read32(const uint8_t* const _Ptr) {
+    uint32_t _Val;
+    memcpy(&_Val, _Ptr, sizeof(uint32_t)); // Windows is always little-endian
+    return _Val;
+}
+
+inline uint64_t _SCFG_CONV _Read64(const uint8_t* const _Ptr) {
+    uint64_t _Val;
+    memcpy(&_Val, _Ptr, sizeof(uint64_t));
+    return _Val;
+}
+
+inline void _SCFG_CONV _Store64(const uint64_t _Val, uint8_t* const _Out) {
+    for (size_t _Idx = 0; _Idx < sizeof(uint64_t); ++_Idx) {
+        _Out[_Idx] = (uint8_t) (_Val >> (56 - 8 * _Idx));
+    }
+}
+
+inline struct _Xxh3_hash128 _SCFG_CONV _Mul128(const uint64_t _Left, const uint64_t _Right) {
+    struct _Xxh3_hash128 _Result;
+#if defined(_M_X64)
+    _Result._Low = _umul128(_Left, _Right, &_Result._High);
+#elif defined(_M_ARM64) // ^^^ _M_X64 ^^^ / vvv _M_ARM64 vvv
+    _Result._Low  = _Left * _Right;
+    _Result._High = __umulh(_Left, _Right);
+#else // ^^^ _M_ARM64 ^^^ / vvv other vvv
+    const uint64_t _Lo_lo = (_Left & 0xFFFFFFFF) * (_Right & 0xFFFFFFFF);
+    const uint64_t _Hi_lo = (_Left >> 32) * (_Right & 0xFFFFFFFF);
+    const uint64_t _Lo_hi = (_Left & 0xFFFFFFFF) * (_Right >> 32);
+    const uint64_t _Hi_hi = (_Left >> 32) * (_Right >> 32);
+    const uint64_t _Cross = (_Lo_lo >> 32) + (_Hi_lo & 0xFFFFFFFF) + _Lo_hi;
+    _Result._High         = (_Hi_lo >> 32) + (_Cross >> 32) + _Hi_hi;
+    _Result._Low          = (_Cross << 32) | (_Lo_lo & 0xFFFFFFFF);
+#endif // _M_X64
+    return _Result;
+}
+
+inline uint64_t _SCFG_CONV _Mul128_fold64(const uint64_t _Left, const uint64_t _Right) {
+    const struct _Xxh3_hash128 _Product = _Mul128(_Left, _Right);
+    return _Product._Low ^ _Product._High;
+}
+
+inline uint64_t _SCFG_CONV _Xxh64_avalanche(uint64_t _Hash) {
+    _Hash ^= _Hash >> 33;
+    _Hash *= _XXH_PRIME64_2;
+    _Hash ^= _Hash >> 29;
+    _Hash *= _XXH_PRIME64_3;
+    _Hash ^= _Hash >> 32;
+    return _Hash;
+}
+
+inline uint64_t _SCFG_CONV _Xxh3_avalanche(uint64_t _Hash) {
+    _Hash ^= _Hash >> 37;
+    _Hash *= _XXH_PRIME_MX1;
+    _Hash ^= _Hash >> 32;
+    return _Hash;
+}
+
+inline uint64_t _SCFG_CONV _Xxh3_rrmxmx(uint64_t _Hash, const uint64_t _Size) {
+    _Hash ^= _rotl64(_Hash, 49) ^ _rotl64(_Hash, 24);
+    _Hash *= _XXH_PRIME_MX2;
+    _Hash ^= (_Hash >> 35) + _Size;
+    _Hash *= _XXH_PRIME_MX2;
+    return _Hash ^ (_Hash >> 28);
+}
+
+inline uint64_t _SCFG_CONV _Mix16(
+    const uint8_t* const _Data, const uint8_t* const _Secret, const uint64_t _Seed) {
+    return _Mul128_fold64(
+        _Read64(_Data) ^ (_Read64(_Secret) + _Seed), _Read64(_Data + 8) ^ (_Read64(_Secret + 8) - _Seed));
+}
+
+inline struct _Xxh3_hash128 _SCFG_CONV _Mix32(struct _Xxh3_hash128 _Acc, const uint8_t* const _First,
+    const uint8_t* const _Second, const uint8_t* const _Secret, const uint64_t _Seed) {
+    _Acc._Low += _Mix16(_First, _Secret, _Seed);
+    _Acc._Low ^= _Read64(_Second) + _Read64(_Second + 8);
+    _Acc._High += _Mix16(_Second, _Secret + 16, _Seed);
+    _Acc._High ^= _Read64(_First) + _Read64(_First + 8);
+    return _Acc;
+}
+
+inline void _SCFG_CONV _Accumulate_stripe(
+    uint64_t* const _Acc, const uint8_t* const _Data, const uint8_t* const _Secret) {
+#if _XXH3_SSE2
+    for (size_t _Idx = 0; _Idx < _XXH3_STRIPE_SIZE / sizeof(__m128i); ++_Idx) {
+        const __m128i _Data_vec = _mm_loadu_si128((const __m128i*) _Data + _Idx);
+        const __m128i _Data_key = _mm_xor_si128(_Data_vec, _mm_loadu_si128((const __m128i*) _Secret + _Idx));
+        const __m128i _Key_high = _mm_shuffle_epi32(_Data_key, _MM_SHUFFLE(0, 3, 0, 1));
+        const __m128i _Product  = _mm_mul_epu32(_Data_key, _Key_high);
+        const __m128i _Sum      = _mm_add_epi64(_mm_loadu_si128((const __m128i*) _Acc + _Idx),
+                 _mm_shuffle_epi32(_Data_vec, _MM_SHUFFLE(1, 0, 3, 2))); // adjacent lanes are swapped
+        _mm_storeu_si128((__m128i*) _Acc + _Idx, _mm_add_epi64(_Product, _Sum));
+    }
+#else // ^^^ _XXH3_SSE2 ^^^ / vvv !_XXH3_SSE2 vvv
+    for (size_t _Idx = 0; _Idx < 8; ++_Idx) {
+        const uint64_t _Data_val = _Read64(_Data + 8 * _Idx);
+        const uint64_t _Data_key = _Data_val ^ _Read64(_Secret + 8 * _Idx);
+        _Acc[_Idx ^ 1] += _Data_val; // adjacent lanes are swapped
+        _Acc[_Idx] += (_Data_key & 0xFFFFFFFF) * (_Data_key >> 32);
+    }
+#endif // _XXH3_SSE2
+}
+
+inline void _SCFG_CONV _Scramble(uint64_t* const _Acc, const uint8_t* const _Secret) {
+#if _XXH3_SSE2
+    const __m128i _Prime = _mm_set1_epi32((int) _XXH_PRIME32_1);
+    for (size_t _Idx = 0; _Idx < _XXH3_STRIPE_SIZE / sizeof(__m128i); ++_Idx) {
+        const __m128i _Acc_vec  = _mm_loadu_si128((const __m128i*) _Acc + _Idx);
+        const __m128i _Data_key = _mm_xor_si128(_mm_xor_si128(_Acc_vec, _mm_srli_epi64(_Acc_vec, 47)),
+            _mm_loadu_si128((const __m128i*) _Secret + _Idx));
+        const __m128i _Low      = _mm_mul_epu32(_Data_key, _Prime);
+        const __m128i _Key_high = _mm_shuffle_epi32(_Data_key, _MM_SHUFFLE(0, 3, 0, 1));
+        const __m128i _High     = _mm_mul_epu32(_Key_high, _Prime);
+        _mm_storeu_si128((__m128i*) _Acc + _Idx, _mm_add_epi64(_Low, _mm_slli_epi64(_High, 32)));
+    }
+#else // ^^^ _XXH3_SSE2 ^^^ / vvv !_XXH3_SSE2 vvv
+    for (size_t _Idx = 0; _Idx < 8; ++_Idx) {
+        const uint64_t _Val = _Acc[_Idx] ^ (_Acc[_Idx] >> 47) ^ _Read64(_Secret + 8 * _Idx);
+        _Acc[_Idx]          = _Val * _XXH_PRIME32_1;
+    }
+#endif // _XXH3_SSE2
+}
+
+inline void _SCFG_CONV _Accumulate(
+    uint64_t* const _Acc, const uint8_t* const _Data, const uint8_t* const _Secret, const size_t _Count) {
+    for (size_t _Idx = 0; _Idx < _Count; ++_Idx) {
+        _Accumulate_stripe(_Acc, _Data + _Idx * _XXH3_STRIPE_SIZE, _Secret + _Idx * _XXH3_SECRET_RATE);
+    }
+}
+
+inline void _SCFG_CONV _Init_acc(uint64_t* const _Acc) {
+    _Acc[0] = _XXH_PRIME32_3;
+    _Acc[1] = _XXH_PRIME64_1;
+    _Acc[2] = _XXH_PRIME64_2;
+    _Acc[3] = _XXH_PRIME64_3;
+    _Acc[4] = _XXH_PRIME64_4;
+    _Acc[5] = _XXH_PRIME32_2;
+    _Acc[6] = _XXH_PRIME64_5;
+    _Acc[7] = _XXH_PRIME32_1;
+}
+
+inline uint64_t _SCFG_CONV _Merge_acc(
+    const uint64_t* const _Acc, const uint8_t* const _Secret, uint64_t _Start) {
+    for (size_t _Idx = 0; _Idx < 4; ++_Idx) {
+        _Start += _Mul128_fold64(_Acc[2 * _Idx] ^ _Read64(_Secret + 16 * _Idx),
+            _Acc[2 * _Idx + 1] ^ _Read64(_Secret + 16 * _Idx + 8));
+    }
+
+    return _Xxh3_avalanche(_Start);
+}
+
+inline struct _Xxh3_hash128 _SCFG_CONV _Merge_acc128(const uint64_t* const _Acc, const uint64_t _Size) {
+    struct _Xxh3_hash128 _Hash;
+    _Hash._Low  = _Merge_acc(_Acc, _Xxh3_secret + _XXH3_MERGE_START, _Size * _XXH_PRIME64_1);
+    _Hash._High = _Merge_acc(_Acc, _Xxh3_secret + _XXH3_SECRET_SIZE - _XXH3_STRIPE_SIZE - _XXH3_MERGE_START,
+        ~(_Size * _XXH_PRIME64_2));
+    return _Hash;
+}
+
+inline void _SCFG_CONV _Hash_long(uint64_t* const _Acc, const uint8_t* const _Data, const size_t _Size) {
+    const size_t _Blocks = (_Size - 1) / _XXH3_BLOCK_SIZE;
+    _Init_acc(_Acc);
+    for (size_t _Idx = 0; _Idx < _Blocks; ++_Idx) {
+        _Accumulate(_Acc, _Data + _Idx * _XXH3_BLOCK_SIZE, _Xxh3_secret, _XXH3_BLOCK_STRIPES);
+        _Scramble(_Acc, _Xxh3_secret + _XXH3_SECRET_LIMIT);
+    }
+
+    const size_t _Stripes = ((_Size - 1) - _Blocks * _XXH3_BLOCK_SIZE) / _XXH3_STRIPE_SIZE;
+    _Accumulate(_Acc, _Data + _Blocks * _XXH3_BLOCK_SIZE, _Xxh3_secret, _Stripes);
+    _Accumulate_stripe(_Acc, _Data + _Size - _XXH3_STRIPE_SIZE,
+        _Xxh3_secret + _XXH3_SECRET_LIMIT - _XXH3_LAST_STRIPE_START); // the last stripe may overlap
+}
+
+inline uint64_t _SCFG_CONV _Hash_short64(const uint8_t* const _Data, const size_t _Size) {
+    const uint8_t* const _Secret = _Xxh3_secret;
+    if (_Size > 128) {
+        uint64_t _Acc = _Size * _XXH_PRIME64_1;
+        for (size_t _Idx = 0; _Idx < 8; ++_Idx) {
+            _Acc += _Mix16(_Data + 16 * _Idx, _Secret + 16 * _Idx, 0);
+        }
+
+        uint64_t _Acc_end =
+            _Mix16(_Data + _Size - 16, _Secret + _XXH3_SECRET_SIZE_MIN - _XXH3_MIDSIZE_LAST, 0);
+        for (size_t _Idx = 8; _Idx < _Size / 16; ++_Idx) {
+            _Acc_end += _Mix16(_Data + 16 * _Idx, _Secret + 16 * (_Idx - 8) + _XXH3_MIDSIZE_START, 0);
+        }
+
+        return _Xxh3_avalanche(_Xxh3_avalanche(_Acc) + _Acc_end);
+    }
+
+    if (_Size > 16) {
+        uint64_t _Acc = _Size * _XXH_PRIME64_1;
+        for (size_t _Idx = (_Size - 1) / 32 + 1; _Idx-- > 0;) { // from the middle towards both ends
+            _Acc += _Mix16(_Data + 16 * _Idx, _Secret + 32 * _Idx, 0);
+            _Acc += _Mix16(_Data + _Size - 16 * (_Idx + 1), _Secret + 32 * _Idx + 16, 0);
+        }
+
+        return _Xxh3_avalanche(_Acc);
+    }
+
+    if (_Size > 8) {
+        const uint64_t _Low  = _Read64(_Data) ^ (_Read64(_Secret + 24) ^ _Read64(_Secret + 32));
+        const uint64_t _High = _Read64(_Data + _Size - 8) ^ (_Read64(_Secret + 40) ^ _Read64(_Secret + 48));
+        return _Xxh3_avalanche(_Size + _byteswap_uint64(_Low) + _High + _Mul128_fold64(_Low, _High));
+    }
+
+    if (_Size >= 4) {
+        const uint64_t _Input = _Read32(_Data + _Size - 4) + ((uint64_t) _Read32(_Data) << 32);
+        return _Xxh3_rrmxmx(_Input ^ (_Read64(_Secret + 8) ^ _Read64(_Secret + 16)), _Size);
+    }
+
+    if (_Size > 0) {
+        const uint32_t _Combined = ((uint32_t) _Data[0] << 16) | ((uint32_t) _Data[_Size >> 1] << 24)
+                                 | (uint32_t) _Data[_Size - 1] | ((uint32_t) _Size << 8);
+        return _Xxh64_avalanche((uint64_t) _Combined ^ (_Read32(_Secret) ^ _Read32(_Secret + 4)));
+    }
+
+    return _Xxh64_avalanche(_Read64(_Secret + 56) ^ _Read64(_Secret + 64));
+}
+
+inline struct _Xxh3_hash128 _SCFG_CONV _Finish_mid128(const struct _Xxh3_hash128 _Acc, const uint64_t _Size) {
+    struct _Xxh3_hash128 _Hash;
+    _Hash._Low  = _Xxh3_avalanche(_Acc._Low + _Acc._High);
+    _Hash._High = 0
+                - _Xxh3_avalanche(
+                    _Acc._Low * _XXH_PRIME64_1 + _Acc._High * _XXH_PRIME64_4 + _Size * _XXH_PRIME64_2);
+    return _Hash;
+}
+
+inline struct _Xxh3_hash128 _SCFG_CONV _Hash_short128(const uint8_t* const _Data, const size_t _Size) {
+    const uint8_t* const _Secret = _Xxh3_secret;
+    struct _Xxh3_hash128 _Acc;
+    if (_Size > 128) {
+        _Acc._Low  = _Size * _XXH_PRIME64_1;
+        _Acc._High = 0;
+        for (size_t _Off = 32; _Off < 160; _Off += 32) {
+            _Acc = _Mix32(_Acc, _Data + _Off - 32, _Data + _Off - 16, _Secret + _Off - 32, 0);
+        }
+
+        _Acc._Low  = _Xxh3_avalanche(_Acc._Low);
+        _Acc._High = _Xxh3_avalanche(_Acc._High);
+        for (size_t _Off = 160; _Off <= _Size; _Off += 32) {
+            _Acc = _Mix32(
+                _Acc, _Data + _Off - 32, _Data + _Off - 16, _Secret + _XXH3_MIDSIZE_START + _Off - 160, 0);
+        }
+
+        _Acc = _Mix32(_Acc, _Data + _Size - 16, _Data + _Size - 32,
+            _Secret + _XXH3_SECRET_SIZE_MIN - _XXH3_MIDSIZE_LAST - 16, 0);
+        return _Finish_mid128(_Acc, _Size);
+    }
+
+    if (_Size > 16) {
+        _Acc._Low  = _Size * _XXH_PRIME64_1;
+        _Acc._High = 0;
+        for (size_t _Idx = (_Size - 1) / 32 + 1; _Idx-- > 0;) { // from the middle towards both ends
+            _Acc = _Mix32(_Acc, _Data + 16 * _Idx, _Data + _Size - 16 * (_Idx + 1), _Secret + 32 * _Idx, 0);
+        }
+
+        return _Finish_mid128(_Acc, _Size);
+    }
+
+    struct _Xxh3_hash128 _Hash;
+    if (_Size > 8) {
+        const uint64_t _Low  = _Read64(_Data);
+        uint64_t _High       = _Read64(_Data + _Size - 8);
+        struct _Xxh3_hash128 _Mixed =
+            _Mul128(_Low ^ _High ^ (_Read64(_Secret + 32) ^ _Read64(_Secret + 40)), _XXH_PRIME64_1);
+        _Mixed._Low += (uint64_t) (_Size - 1) << 54;
+        _High ^= _Read64(_Secret + 48) ^ _Read64(_Secret + 56);
+        _Mixed._High += _High + (uint64_t) (uint32_t) _High * (_XXH_PRIME32_2 - 1);
+        _Mixed._Low ^= _byteswap_uint64(_Mixed._High);
+        _Hash = _Mul128(_Mixed._Low, _XXH_PRIME64_2);
+        _Hash._High += _Mixed._High * _XXH_PRIME64_2;
+        _Hash._Low  = _Xxh3_avalanche(_Hash._Low);
+        _Hash._High = _Xxh3_avalanche(_Hash._High);
+        return _Hash;
+    }
+
+    if (_Size >= 4) {
+        const uint64_t _Input = _Read32(_Data) + ((uint64_t) _Read32(_Data + _Size - 4) << 32);
+        _Hash = _Mul128(
+            _Input ^ (_Read64(_Secret + 16) ^ _Read64(_Secret + 24)), _XXH_PRIME64_1 + (_Size << 2));
+        _Hash._High += _Hash._Low << 1;
+        _Hash._Low ^= _Hash._High >> 3;
+        _Hash._Low ^= _Hash._Low >> 35;
+        _Hash._Low *= _XXH_PRIME_MX2;
+        _Hash._Low ^= _Hash._Low >> 28;
+        _Hash._High = _Xxh3_avalanche(_Hash._High);
+        return _Hash;
+    }
+
+    if (_Size > 0) {
+        const uint32_t _Combined = ((uint32_t) _Data[0] << 16) | ((uint32_t) _Data[_Size >> 1] << 24)
+                                 | (uint32_t) _Data[_Size - 1] | ((uint32_t) _Size << 8);
+        _Hash._Low  = _Xxh64_avalanche((uint64_t) _Combined ^ (_Read32(_Secret) ^ _Read32(_Secret + 4)));
+        _Hash._High = _Xxh64_avalanche((uint64_t) _rotl(_byteswap_ulong(_Combined), 13)
+                                       ^ (_Read32(_Secret + 8) ^ _Read32(_Secret + 12)));
+        return _Hash;
+    }
+
+    _Hash._Low  = _Xxh64_avalanche(_Read64(_Secret + 64) ^ _Read64(_Secret + 72));
+    _Hash._High = _Xxh64_avalanche(_Read64(_Secret + 80) ^ _Read64(_Secret + 88));
+    return _Hash;
+}
+
+inline void _SCFG_CONV _Store_hash128(const struct _Xxh3_hash128 _Hash, uint8_t* const _Out) {
+    _Store64(_Hash._High, _Out);
+    _Store64(_Hash._Low, _Out + 8);
+}
+
+inline const uint8_t* _SCFG_CONV _Consume_stripes(
+    uint64_t* const _Acc, size_t* const _Stripes, const uint8_t* _Data, size_t _Count) {
+    const uint8_t* _Secret = _Xxh3_secret + *_Stripes * _XXH3_SECRET_RATE;
+    if (_Count >= _XXH3_BLOCK_STRIPES - *_Stripes) { // finish the current block first
+        size_t _Block_stripes = _XXH3_BLOCK_STRIPES - *_Stripes;
+        do {
+            _Accumulate(_Acc, _Data, _Secret, _Block_stripes);
+            _Scramble(_Acc, _Xxh3_secret + _XXH3_SECRET_LIMIT);
+            _Data += _Block_stripes * _XXH3_STRIPE_SIZE;
+            _Count -= _Block_stripes;
+            _Block_stripes = _XXH3_BLOCK_STRIPES;
+            _Secret        = _Xxh3_secret;
+        } while (_Count >= _XXH3_BLOCK_STRIPES);
+
+        *_Stripes = 0;
+    }
+
+    if (_Count > 0) {
+        _Accumulate(_Acc, _Data, _Secret, _Count);
+        _Data += _Count * _XXH3_STRIPE_SIZE;
+        *_Stripes += _Count;
+    }
+
+    return _Data;
+}
+
+inline void _SCFG_CONV _Digest_long(const struct _Xxh3_state* const _State, uint64_t* const _Acc) {
+    uint8_t _Last_stripe[_XXH3_STRIPE_SIZE];
+    const uint8_t* _Last_ptr;
+    memcpy(_Acc, _State->_Acc, sizeof(_State->_Acc));
+    if (_State->_Buffered >= _XXH3_STRIPE_SIZE) {
+        size_t _Stripes = _State->_Stripes;
+        _Consume_stripes(_Acc, &_Stripes, _State->_Buffer, (_State->_Buffered - 1) / _XXH3_STRIPE_SIZE);
+        _Last_ptr = _State->_Buffer + _State->_Buffered - _XXH3_STRIPE_SIZE;
+    } else { // the last stripe starts in the previous contents of the buffer
+        const size_t _Catchup = _XXH3_STRIPE_SIZE - _State->_Buffered;
+        memcpy(_Last_stripe, _State->_Buffer + _XXH3_BUFFER_SIZE - _Catchup, _Catchup);
+        memcpy(_Last_stripe + _Catchup, _State->_Buffer, _State->_Buffered);
+        _Last_ptr = _Last_stripe;
+    }
+
+    _Accumulate_stripe(_Acc, _Last_ptr, _Xxh3_secret + _XXH3_SECRET_LIMIT - _XXH3_LAST_STRIPE_START);
+}
+
+scfg_hash_kernel_t _SCFG_CONV _Get_xxh3_kernel(void) {
+    return _XXH3_SSE2 ? scfg_hash_kernel_sse2 : scfg_hash_kernel_portable;
+}
+
+void _SCFG_CONV _Xxh3_64(const uint8_t* const _Data, const size_t _Size, uint8_t* const _Out) {
+    if (_Size <= _XXH3_MIDSIZE_MAX) {
+        _Store64(_Hash_short64(_Data, _Size), _Out);
+    } else {
+        uint64_t _Acc[8];
+        _Hash_long(_Acc, _Data, _Size);
+        _Store64(_Merge_acc(_Acc, _Xxh3_secret + _XXH3_MERGE_START, (uint64_t) _Size * _XXH_PRIME64_1), _Out);
+    }
+}
+
+void _SCFG_CONV _Xxh3_128(const uint8_t* const _Data, const size_t _Size, uint8_t* const _Out) {
+    if (_Size <= _XXH3_MIDSIZE_MAX) {
+        _Store_hash128(_Hash_short128(_Data, _Size), _Out);
+    } else {
+        uint64_t _Acc[8];
+        _Hash_long(_Acc, _Data, _Size);
+        _Store_hash128(_Merge_acc128(_Acc, (uint64_t) _Size), _Out);
+    }
+}
+
+void _SCFG_CONV _Xxh3_init(struct _Xxh3_state* const _State) {
+    _Init_acc(_State->_Acc);
+    _State->_Buffered = 0;
+    _State->_Stripes  = 0;
+    _State->_Total    = 0;
+}
+
+void _SCFG_CONV _Xxh3_update(struct _Xxh3_state* const _State, const uint8_t* _Data, const size_t _Size) {
+    if (_Size == 0) {
+        return;
+    }
+
+    const uint8_t* const _End = _Data + _Size;
+    _State->_Total += _Size;
+    if (_Size <= _XXH3_BUFFER_SIZE - _State->_Buffered) { // the buffer is not full yet
+        memcpy(_State->_Buffer + _State->_Buffered, _Data, _Size);
+        _State->_Buffered += _Size;
+        return;
+    }
+
+    if (_State->_Buffered > 0) {
+        const size_t _Fill = _XXH3_BUFFER_SIZE - _State->_Buffered;
+        memcpy(_State->_Buffer + _State->_Buffered, _Data, _Fill);
+        _Data += _Fill;
+        _Consume_stripes(
+            _State->_Acc, &_State->_Stripes, _State->_Buffer, _XXH3_BUFFER_SIZE / _XXH3_STRIPE_SIZE);
+        _State->_Buffered = 0;
+    }
+
+    // Note: At least one byte is always left in the buffer. If the rest of the data is hashed in place,
+    //       its last stripe is kept at the end of the buffer, because the final stripe may overlap it.
+    if ((size_t) (_End - _Data) > _XXH3_BUFFER_SIZE) {
+        _Data = _Consume_stripes(
+            _State->_Acc, &_State->_Stripes, _Data, (size_t) (_End - 1 - _Data) / _XXH3_STRIPE_SIZE);
+        memcpy(_State->_Buffer + _XXH3_BUFFER_SIZE - _XXH3_STRIPE_SIZE, _Data - _XXH3_STRIPE_SIZE,
+            _XXH3_STRIPE_SIZE);
+    }
+
+    memcpy(_State->_Buffer, _Data, (size_t) (_End - _Data));
+    _State->_Buffered = (size_t) (_End - _Data);
+}
+
+void _SCFG_CONV _Xxh3_finalize_64(const struct _Xxh3_state* const _State, uint8_t* const _Out) {
+    if (_State->_Total <= _XXH3_MIDSIZE_MAX) { // the whole input is still in the buffer
+        _Xxh3_64(_State->_Buffer, (size_t) _State->_Total, _Out);
+    } else {
+        uint64_t _Acc[8];
+        _Digest_long(_State, _Acc);
+        _Store64(_Merge_acc(_Acc, _Xxh3_secret + _XXH3_MERGE_START, _State->_Total * _XXH_PRIME64_1), _Out);
+    }
+}
+
+void _SCFG_CONV _Xxh3_finalize_128(const struct _Xxh3_state* const _State, uint8_t* const _Out) {
+    if (_State->_Total <= _XXH3_MIDSIZE_MAX) {
+        _Xxh3_128(_State->_Buffer, (size_t) _State->_Total, _Out);
+    } else {
+        uint64_t _Acc[8];
+        _Digest_long(_State, _Acc);
+        _Store_hash128(_Merge_acc128(_Acc, _State->_Total), _Out);
+    }
+}
\ No newline at end of file